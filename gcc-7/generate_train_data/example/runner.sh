@@ -4,6 +4,7 @@ EXE_PATH="../generate_train_data"
 PROCESSES=2
 THREADS=1
 ITERATIONS=100000
+SEARCH_GROUPS=1 # root-parallel: each group of threads searches its own trees
 
 pid_file="pid.file"
 
@@ -33,7 +34,7 @@ runner()
   local filename="$2"
   echo "Starting a process '${exe_path}' to file '${filename}'"
   while true; do
-    "$1" "$THREADS" "$ITERATIONS" >> "${filename}" 2>&1
+    "$1" "$THREADS" "$ITERATIONS" "$SEARCH_GROUPS" >> "${filename}" 2>&1
     sleep 1
   done
 }
@@ -45,7 +45,8 @@ namespace Cards
 		Card_DS1_184() {
 			onplay_handler.SetOnPlayCallback([](FlowControl::onplay::context::OnPlay const& context) {
 				auto & deck = context.manipulate_.Board().Player(context.player_).deck_;
-				std::vector<Cards::CardId> cards;
+				thread_local std::vector<Cards::CardId> cards; // reused by the thread
+				cards.clear();
 				for (int i = 0; i < 3; ++i) {
 					if (deck.Empty()) break;
 					cards.push_back(deck.GetLast());
@@ -71,7 +71,7 @@ namespace Cards
 			});
 			onplay_handler.SetOnPlayCallback([](FlowControl::onplay::context::OnPlay const& context) {
 				std::array<bool, 4> totems_exists = GetTotemExists(context.manipulate_, context.player_);
-				std::vector<Cards::CardId> totems_candidates;
+				Utils::StaticVector<Cards::CardId, 4> totems_candidates;
 				for (int i = 0; i < 4; ++i) {
 					if (totems_exists[i]) continue;
 					totems_candidates.push_back(basic_totems_[i]);
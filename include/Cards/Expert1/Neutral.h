@@ -425,7 +425,7 @@ namespace Cards
 			state::PlayerIdentifier player = context.manipulate_.GetCard(self).GetPlayerIdentifier();
 			if (context.manipulate_.Board().GetCurrentPlayerId() != player) return true;
 
-			std::vector<state::CardRef> candidates;
+			Utils::StaticVector<state::CardRef, state::board::Hand::max_cards_> candidates;
 			context.manipulate_.Board().Player(player).hand_.ForEach([&](state::CardRef ref) {
 				if (context.manipulate_.GetCard(ref).GetCardType() != state::kCardTypeMinion) return true;
 				candidates.push_back(ref);
@@ -138,7 +138,7 @@ namespace Cards
 				return true;
 			});
 			onplay_handler.SetOnPlayCallback([](FlowControl::onplay::context::OnPlay const& context) {
-				std::vector<Cards::CardId> possibles;
+				Utils::StaticVector<Cards::CardId, state::board::Deck::max_size> possibles;
 				context.manipulate_.Board().Player(context.player_).deck_.ForEach([&](Cards::CardId in_card_id) {
 					if (Cards::CardDispatcher::CreateInstance(in_card_id).card_type == state::kCardTypeMinion) {
 						possibles.push_back(in_card_id);
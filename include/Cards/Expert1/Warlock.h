@@ -63,7 +63,7 @@ namespace Cards
 	struct Card_EX1_317 : SpellCardBase<Card_EX1_317> {
 		Card_EX1_317() {
 			onplay_handler.SetOnPlayCallback([](FlowControl::onplay::context::OnPlay const& context) {
-				std::vector<Cards::CardId> possibles;
+				Utils::StaticVector<Cards::CardId, state::board::Deck::max_size> possibles;
 				context.manipulate_.Board().Player(context.player_).deck_.ForEach([&](Cards::CardId in_card_id) {
 					if (Cards::CardDispatcher::CreateInstance(in_card_id).card_race == state::kCardRaceDemon) {
 						possibles.push_back(in_card_id);
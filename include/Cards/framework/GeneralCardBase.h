@@ -6,6 +6,7 @@
 #include "Cards/BattlecryHelper.h"
 #include "Cards/MinionCardUtils.h"
 #include "Cards/CardAttributes.h"
+#include "Utils/StaticVector.h"
 
 namespace Cards
 {
@@ -189,7 +190,9 @@ namespace Cards
 			std::array<int, 3> choice_indics = GetAtMostRandomThreeNumbers(manipulate, (int)container.size());
 			size_t choice_indics_size = std::min(container.size(), (size_t)3);
 
-			std::vector<Cards::CardId> choices;
+			// Reused by the thread, UserChooseOne() is not reentrant
+			thread_local std::vector<Cards::CardId> choices;
+			choices.clear();
 			for (size_t i = 0; i < choice_indics_size; ++i) {
 				choices.push_back((Cards::CardId)container[choice_indics[i]]);
 			}
@@ -30,7 +30,10 @@ namespace FlowControl {
 	{
 		int play_order = state.GetCardsManager().Get(ref).GetPlayOrder();
 
-		dead_entity_hints_.insert(std::make_pair(play_order, ref));
+		// after the hints with the same play order, like a multimap
+		auto it = std::upper_bound(dead_entity_hints_.begin(), dead_entity_hints_.end(), play_order,
+			[](int lhs, std::pair<int, state::CardRef> const& rhs) { return lhs < rhs.first; });
+		dead_entity_hints_.insert(it, std::make_pair(play_order, ref));
 	}
 
 	inline bool FlowContext::Empty() const
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "state/IRandomGenerator.h"
 #include "state/Types.h"
@@ -19,7 +21,7 @@ namespace FlowControl {
 			minion_put_location_(-1),
 			specified_target_(), destroyed_weapon_(),
 			user_choice_(Cards::kInvalidCardId),
-			targets_(),
+			targets_(), defenders_(), random_targets_(), aura_targets_(),
 			resolver_()
 		{}
 
@@ -30,7 +32,7 @@ namespace FlowControl {
 			minion_put_location_(-1),
 			specified_target_(), destroyed_weapon_(),
 			user_choice_(Cards::kInvalidCardId),
-			targets_(),
+			targets_(), defenders_(), random_targets_(), aura_targets_(),
 			resolver_()
 		{}
 
@@ -88,6 +90,7 @@ namespace FlowControl {
 	public: // dead entry hint
 		void AddDeadEntryHint(state::State & state, state::CardRef ref);
 
+		// The hints are visited by order of play
 		template <typename T>
 		void ForEachDeadEntryHint(T&& functor) {
 			for (auto const& item: dead_entity_hints_) {
@@ -119,16 +122,35 @@ namespace FlowControl {
 	public:
 		auto & GetResolver() { return resolver_; }
 
+	public: // scratch buffers
+		// Reused across actions, so no heap allocation is needed once warmed up
+		// The content is only valid until the next call
+		std::vector<state::CardRef> & GetDefendersBuffer() {
+			defenders_.clear();
+			return defenders_;
+		}
+		std::vector<state::CardRef> & GetRandomTargetsBuffer() {
+			random_targets_.clear();
+			return random_targets_;
+		}
+		std::vector<state::CardRef> & GetAuraTargetsBuffer() {
+			aura_targets_.clear();
+			return aura_targets_;
+		}
+
 	private:
 		Result result_;
 		IActionParameterGetter * action_parameters_;
 		state::IRandomGenerator * random_;
-		std::multimap<int, state::CardRef> dead_entity_hints_;
+		std::vector<std::pair<int, state::CardRef>> dead_entity_hints_; // sorted by play order
 		int minion_put_location_;
 		state::CardRef specified_target_;
 		state::CardRef destroyed_weapon_;
 		Cards::CardId user_choice_;
 		std::vector<state::CardRef> targets_;
+		std::vector<state::CardRef> defenders_;
+		std::vector<state::CardRef> random_targets_;
+		std::vector<state::CardRef> aura_targets_;
 		detail::Resolver resolver_;
 	};
 }
\ No newline at end of file
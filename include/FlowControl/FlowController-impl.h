@@ -345,7 +345,7 @@ namespace FlowControl
 
 	inline state::CardRef FlowController::GetDefender(state::CardRef attacker)
 	{
-		std::vector<state::CardRef> defenders;
+		std::vector<state::CardRef> & defenders = flow_context_.GetDefendersBuffer();
 
 		auto HasTaunt = [&](state::CardRef card_ref) {
 			state::Cards::Card const& card = state_.GetCard(card_ref);
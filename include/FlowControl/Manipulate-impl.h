@@ -81,7 +81,7 @@ namespace FlowControl
 
 	inline state::CardRef Manipulate::GetRandomTarget(state::targetor::Targets const & target_info) const
 	{
-		std::vector<state::CardRef> targets;
+		std::vector<state::CardRef> & targets = flow_context_.GetRandomTargetsBuffer();
 		target_info.Fill(state_, targets);
 
 		size_t count = targets.size();
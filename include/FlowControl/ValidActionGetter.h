@@ -117,19 +117,17 @@ namespace FlowControl
 			return state_.GetCurrentPlayer().minions_.Get((size_t)(attacker_idx));
 		}
 
-		std::vector<state::CardRef> GetDefenders() {
-			std::vector<state::CardRef> defenders;
+		// Functor: bool(state::CardRef), return true to continue; false to stop
+		template <typename Functor>
+		void ForEachDefender(Functor&& functor) {
 			auto const& player = state_.GetBoard().Get(state_.GetCurrentPlayerId().Opposite());
 
 			state::CardRef hero_ref = player.GetHeroRef();
-			defenders.push_back(hero_ref);
+			if (!functor(hero_ref)) return;
 
 			player.minions_.ForEach([&](state::CardRef card_ref) {
-				defenders.push_back(card_ref);
-				return true;
+				return functor(card_ref);
 			});
-
-			return defenders;
 		}
 
 		bool HeroPowerUsable() {
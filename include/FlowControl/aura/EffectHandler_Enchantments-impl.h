@@ -19,7 +19,8 @@ namespace FlowControl
 			assert(get_targets);
 			assert(apply_on);
 
-			std::vector<state::CardRef> new_targets;
+			// Auras are updated one by one, so they share the same buffer
+			std::vector<state::CardRef> & new_targets = flow_context.GetAuraTargetsBuffer();
 			if (aura_valid) (*get_targets)({ Manipulate(state, flow_context), card_ref, new_targets });
 
 			for (auto it = applied_enchantments.begin(), it2 = applied_enchantments.end(); it != it2;)
@@ -32,9 +32,20 @@ namespace FlowControl
 			}
 
 			void FillWithBase(Handler const& base) {
-				assert(base.base_deathrattles_ == nullptr);
-				base_deathrattles_ = &base.deathrattles_;
 				deathrattles_.clear();
+
+				// The base might have its own base
+				if (!base.base_deathrattles_) {
+					base_deathrattles_ = &base.deathrattles_;
+				}
+				else if (base.deathrattles_.empty()) {
+					base_deathrattles_ = base.base_deathrattles_;
+				}
+				else {
+					base_deathrattles_ = nullptr;
+					deathrattles_ = *base.base_deathrattles_;
+					deathrattles_.insert(deathrattles_.end(), base.deathrattles_.begin(), base.deathrattles_.end());
+				}
 			}
 
 			void Clear() {
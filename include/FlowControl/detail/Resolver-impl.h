@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "state/State.h"
 #include "FlowControl/FlowContext.h"
 #include "FlowControl/Manipulate.h"
@@ -103,7 +105,10 @@ namespace FlowControl
 				int zone_pos = card.GetZonePosition();
 				int attack = card.GetAttack();
 
-				ordered_deaths_.insert(std::make_pair(card.GetPlayOrder(),
+				int play_order = card.GetPlayOrder();
+				auto it = std::upper_bound(ordered_deaths_.begin(), ordered_deaths_.end(), play_order,
+					[](int lhs, auto const& rhs) { return lhs < rhs.first; });
+				ordered_deaths_.insert(it, std::make_pair(play_order,
 					DeathProcessor(ref, player, zone, zone_pos, attack)));
 			}
 
@@ -1,7 +1,8 @@
 #pragma once
 
 #include <unordered_set>
-#include <map>
+#include <utility>
+#include <vector>
 #include "FlowControl/Result.h"
 
 namespace state {
@@ -49,7 +50,7 @@ namespace FlowControl
 
 		private:
 			std::vector<state::CardRef> deaths_;
-			std::multimap<int, DeathProcessor> ordered_deaths_;
+			std::vector<std::pair<int, DeathProcessor>> ordered_deaths_; // sorted by play order
 			std::vector<state::CardRef> minions_refs_; // a cache for process
 		};
 	}
@@ -44,8 +44,7 @@ namespace FlowControl
 			}
 
 			void FillWithBase(Enchantments const& base) {
-				assert(base.base_enchantments_ == nullptr);
-				base_enchantments_ = &base.enchantments_;
+				base_enchantments_ = &base.GetEnchantmentsForRead(); // the base might have its own base
 				update_decider_ = base.update_decider_;
 			}
 
@@ -16,7 +16,7 @@ namespace FlowControl
 		inline void Handler::Update(state::State & state, FlowContext & flow_context, state::CardRef card_ref, bool allow_hp_reduce) {
 			if (!enchantments.NeedUpdate(state)) return;
 
-			auto GetCard = [&]() { return state.GetCard(card_ref); };
+			auto GetCard = [&]() -> state::Cards::Card const& { return state.GetCard(card_ref); };
 
 			int origin_hp = GetCard().GetHP();
 
@@ -61,9 +61,9 @@ namespace FlowControl
 		inline void Handler::UpdateCard(state::State & state, FlowContext & flow_context, state::CardRef card_ref, state::Cards::EnchantableStates const & new_states)
 		{
 			static_assert(state::Cards::EnchantableStates::kFieldChangeId == 17, "enchantable fields changed");
-			auto GetCard = [&]() { return state.GetCard(card_ref); };
+			auto GetCard = [&]() -> state::Cards::Card const& { return state.GetCard(card_ref); };
 
-			state::Cards::EnchantableStates const& current_states = GetCard().GetRawData().enchanted_states;
+			state::Cards::EnchantableStates const current_states = GetCard().GetRawData().enchanted_states;
 
 			auto card_manipulator = Manipulators::CardManipulator(state, flow_context, card_ref);
 
@@ -76,9 +76,9 @@ namespace FlowControl
 		inline void Handler::UpdateCharacter(state::State & state, FlowContext & flow_context, state::CardRef card_ref, state::Cards::EnchantableStates const& new_states)
 		{
 			static_assert(state::Cards::EnchantableStates::kFieldChangeId == 17, "enchantable fields changed");
-			auto GetCard = [&]() { return state.GetCard(card_ref); };
+			auto GetCard = [&]() -> state::Cards::Card const& { return state.GetCard(card_ref); };
 
-			state::Cards::EnchantableStates const& current_states = GetCard().GetRawData().enchanted_states;
+			state::Cards::EnchantableStates const current_states = GetCard().GetRawData().enchanted_states;
 
 			UpdateCard(state, flow_context, card_ref, new_states);
 
@@ -125,8 +125,8 @@ namespace FlowControl
 		inline void Handler::UpdateMinion(state::State & state, FlowContext & flow_context, state::CardRef card_ref, state::Cards::EnchantableStates const& new_states)
 		{
 			static_assert(state::Cards::EnchantableStates::kFieldChangeId == 17, "enchantable fields changed");
-			auto GetCard = [&]() { return state.GetCard(card_ref); };
-			state::Cards::EnchantableStates const& current_states = GetCard().GetRawData().enchanted_states;
+			auto GetCard = [&]() -> state::Cards::Card const& { return state.GetCard(card_ref); };
+			state::Cards::EnchantableStates const current_states = GetCard().GetRawData().enchanted_states;
 
 			UpdateCharacter(state, flow_context, card_ref, new_states);
 
@@ -168,8 +168,8 @@ namespace FlowControl
 		inline void Handler::UpdateWeapon(state::State & state, FlowContext & flow_context, state::CardRef card_ref, state::Cards::EnchantableStates const& new_states)
 		{
 			static_assert(state::Cards::EnchantableStates::kFieldChangeId == 17, "enchantable fields changed");
-			auto GetCard = [&]() { return state.GetCard(card_ref); };
-			state::Cards::EnchantableStates const& current_states = GetCard().GetRawData().enchanted_states;
+			auto GetCard = [&]() -> state::Cards::Card const& { return state.GetCard(card_ref); };
+			state::Cards::EnchantableStates const current_states = GetCard().GetRawData().enchanted_states;
 
 			UpdateCard(state, flow_context, card_ref, new_states);
 
@@ -25,8 +25,7 @@ namespace FlowControl
 			}
 
 			void FillWithBase(Handler const& base) {
-				assert(base.base_origin_states == nullptr);
-				base_origin_states = &base.origin_states;
+				base_origin_states = &base.GetOriginalStates(); // the base might have its own base
 				enchantments.FillWithBase(base.enchantments);
 			}
 
@@ -13,18 +13,37 @@ namespace mcts
 	public:
 		MOMCTS(builder::TreeBuilder::TreeNode & first_tree,
 			builder::TreeBuilder::TreeNode & second_tree,
-			Statistic<> & statistic,
+			Statistic<> & statistic, TreeBudget & budget,
 			std::mt19937 & selection_rand, std::mt19937 & simulation_rand
 		) :
-			first_(state::kPlayerFirst, first_tree, statistic, selection_rand, simulation_rand),
-			second_(state::kPlayerSecond, second_tree, statistic, selection_rand, simulation_rand)
+			first_(state::kPlayerFirst, first_tree, statistic, budget, selection_rand, simulation_rand),
+			second_(state::kPlayerSecond, second_tree, statistic, budget, selection_rand, simulation_rand)
 		{}
 
+		MOMCTS(MOMCTS const&) = delete;
+		MOMCTS & operator=(MOMCTS const&) = delete;
+
+		// Continue on other trees, so the scratch (the tree builders with their
+		// flow contexts and policies) is reused across the searches
+		// Should be called between the iterations
+		void Rebind(builder::TreeBuilder::TreeNode & first_tree,
+			builder::TreeBuilder::TreeNode & second_tree,
+			Statistic<> & statistic, TreeBudget & budget)
+		{
+			first_.Rebind(first_tree, statistic, budget);
+			second_.Rebind(second_tree, statistic, budget);
+		}
+
 		template <typename StartBoardGetter>
 		void Iterate(StartBoardGetter&& start_board_getter)
 		{
 			state::State state = start_board_getter();
+			Iterate(state);
+		}
 
+		// 'state' is played until the game ends
+		void Iterate(state::State & state)
+		{
 			first_.StartEpisode();
 			second_.StartEpisode();
 
@@ -6,6 +6,7 @@
 #include "board/Board.h"
 #include "builder/TreeBuilder.h"
 #include "MCTS/detail/BoardNodeMap.h"
+#include "MCTS/TreeBudget.h"
 
 namespace mcts
 {
@@ -20,19 +21,29 @@ namespace mcts
 	{		
 	public:
 		SOMCTS(state::PlayerSide side, builder::TreeBuilder::TreeNode & root, Statistic<> & statistic,
-			std::mt19937 & selection_rand, std::mt19937 & simulation_rand)
+			TreeBudget & budget, std::mt19937 & selection_rand, std::mt19937 & simulation_rand)
 			:
-			side_(side), root_(root), statistic_(statistic),
-			builder_(side, *this, statistic_, selection_rand, simulation_rand),
+			side_(side), root_(&root), budget_(&budget),
+			builder_(side, *this, statistic, budget, selection_rand, simulation_rand),
 			node_(nullptr), stage_(Stage::kStageSelection), updater_()
 		{}
 
 		SOMCTS(SOMCTS const&) = delete;
 		SOMCTS & operator=(SOMCTS const&) = delete;
 
+		// Continue on another tree, keeping the builder (and its flow context
+		// and policies)
+		// Should not be called in the middle of an episode
+		void Rebind(builder::TreeBuilder::TreeNode & root, Statistic<> & statistic, TreeBudget & budget)
+		{
+			root_ = &root;
+			budget_ = &budget;
+			builder_.Rebind(statistic, budget);
+		}
+
 		void StartEpisode()
 		{
-			node_ = &root_;
+			node_ = root_;
 			stage_ = kStageSelection;
 			updater_.Clear();
 		}
@@ -76,8 +87,8 @@ namespace mcts
 					result = perform_result.result;
 					if (result.type_ != Result::kResultNotDetermined) return result;
 
-					assert([](builder::TreeBuilder::TreeNode* node) {
-						if (!node) return false;
+					assert([&](builder::TreeBuilder::TreeNode* node) {
+						if (!node) return perform_result.change_to_simulation; // expansion suspended
 						if (!node->GetActionType().IsValid()) return true;
 						return node->GetActionType().GetType() == ActionType::kMainAction;
 					}(perform_result.node));
@@ -106,7 +117,16 @@ namespace mcts
 			assert(stage_ == kStageSelection);
 			assert(node_);
 
-			node_ = node_->GetAddon().board_node_map.GetOrCreateNode(board);
+			auto & board_node_map = node_->GetAddon().board_node_map;
+			if (budget_->IsExhausted()) {
+				node_ = board_node_map.GetNode(board);
+				if (!node_) stage_ = kStageSimulation;
+				return;
+			}
+
+			bool new_node_created = false;
+			node_ = board_node_map.GetOrCreateNode(board, &new_node_created);
+			if (new_node_created) budget_->AddNodes(1);
 		}
 
 		void EpisodeFinished(state::State const& state, Result result)
@@ -130,12 +150,12 @@ namespace mcts
 			}
 		}
 
-		auto GetRootNode() const { return &root_; }
+		auto GetRootNode() const { return root_; }
 
 	private:
 		const state::PlayerSide side_;
-		builder::TreeBuilder::TreeNode & root_;
-		Statistic<> & statistic_;
+		builder::TreeBuilder::TreeNode * root_;
+		TreeBudget * budget_;
 
 	private: // traversal progress
 		builder::TreeBuilder builder_;
@@ -4,6 +4,7 @@
 #include <sstream>
 
 #include "MCTS/Config.h"
+#include "MCTS/detail/LockSites.h"
 
 namespace mcts
 {
@@ -80,10 +81,27 @@ namespace mcts
 			PrintRate(ss, iterate_);
 			ss << std::endl;
 
+			ss << "Lock contentions:" << std::endl;
+			PrintContentions<detail::BoardNodeMapSite>(ss, "BoardNodeMap");
+			PrintContentions<detail::ChildNodeMapSite>(ss, "ChildNodeMap");
+			PrintContentions<detail::BoardActionAnalyzerSite>(ss, "BoardActionAnalyzer");
+			PrintContentions<detail::TreeNodeLeadingNodesSite>(ss, "TreeNodeLeadingNodes");
+
 			return ss.str();
 		}
 
+		// Contended acquisitions of a lock site (process-wide)
+		template <class Site>
+		static std::uint64_t GetContentions() {
+			return detail::SiteContentionRecorder<Site>::GetContentions();
+		}
+
 	private:
+		template <class Site>
+		static void PrintContentions(std::stringstream & ss, char const* name) {
+			ss << "   " << name << ": " << GetContentions<Site>() << std::endl;
+		}
+
 		void PrintRate(std::stringstream & ss, detail::SuccessRateRecorder const& rate) const {
 			ss << rate.GetSuccessCount()
 				<< " / " << rate.GetTotalCount()
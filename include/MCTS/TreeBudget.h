@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+namespace mcts
+{
+	// Limits the growth of the search trees
+	// Once the number of tree nodes, or the bytes allocated for the trees,
+	// reaches the limit, no new node is created after a main action. Selection
+	// only follows the existing nodes, and switches to simulation otherwise.
+	// Thread safety: Yes
+	class TreeBudget
+	{
+	public:
+		static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+
+		TreeBudget() : max_nodes_(kUnlimited), max_bytes_(kUnlimited), nodes_(0), bytes_(0) {}
+
+		TreeBudget(TreeBudget const&) = delete;
+		TreeBudget & operator=(TreeBudget const&) = delete;
+
+		void SetLimits(size_t max_nodes, size_t max_bytes) {
+			max_nodes_.store(max_nodes, std::memory_order_relaxed);
+			max_bytes_.store(max_bytes, std::memory_order_relaxed);
+		}
+		size_t GetMaxNodes() const { return max_nodes_.load(std::memory_order_relaxed); }
+		size_t GetMaxBytes() const { return max_bytes_.load(std::memory_order_relaxed); }
+
+		void AddNodes(size_t v) {
+			if (v) nodes_.fetch_add(v, std::memory_order_relaxed);
+		}
+		void SetNodes(size_t v) { nodes_.store(v, std::memory_order_relaxed); }
+		void SetBytes(size_t v) { bytes_.store(v, std::memory_order_relaxed); }
+
+		// Nodes reachable from the roots
+		size_t GetNodes() const { return nodes_.load(std::memory_order_relaxed); }
+
+		// Bytes allocated for the trees reachable from the roots (see
+		// ui::AIController::UpdateRoot)
+		size_t GetBytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+		bool IsExhausted() const {
+			return GetNodes() >= GetMaxNodes() || GetBytes() >= GetMaxBytes();
+		}
+
+	private:
+		std::atomic<size_t> max_nodes_;
+		std::atomic<size_t> max_bytes_;
+		std::atomic<size_t> nodes_;
+		std::atomic<size_t> bytes_;
+	};
+}
@@ -4,6 +4,7 @@
 #include <vector>
 #include <functional>
 #include "Cards/id-map.h"
+#include "Utils/StaticVector.h"
 
 namespace mcts
 {
@@ -18,6 +19,9 @@ namespace mcts
 				kChooseFromCardIds
 			};
 
+			// At most three cards are offered (e.g., discover), with some room to spare
+			static constexpr size_t kMaxCardIds = 8;
+
 		public:
 			explicit ActionChoices(int exclusive_max) :
 				type_(kChooseFromZeroToExclusiveMax),
@@ -124,11 +128,12 @@ namespace mcts
 
 			int exclusive_max_;
 
-			std::vector<Cards::CardId> card_ids_;
+			// Stored inline, since the choices are copied around by value
+			Utils::StaticVector<Cards::CardId, kMaxCardIds> card_ids_;
 
 		private: // iterate progress
 			int range_it_;
-			std::vector<Cards::CardId>::iterator card_ids_it_;
+			Utils::StaticVector<Cards::CardId, kMaxCardIds>::const_iterator card_ids_it_;
 		};
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include "MCTS/board/BoardActionAnalyzer.h"
 #include "MCTS/board/BoardActionAnalyzer-impl.h"
 #include "MCTS/board/BoardView.h"
@@ -61,6 +62,24 @@ namespace mcts
 				}
 			}
 
+			// Boards with the same view have the same fingerprint
+			// The board hash is maintained incrementally by state::State; only the
+			// attackable flags (which depend on the game rules) are computed here
+			std::uint64_t GetFingerprint() const {
+				std::uint64_t hash = board_.GetViewHash(side_);
+				ApplyWithPlayerStateView([&](auto const& view) {
+					hash += state::BoardHash::Key(state::BoardHash::kTagHeroAttackable,
+						view.IsHeroAttackable(side_));
+					int idx = 0;
+					view.ForEachMinion(side_, [&](state::Cards::Card const&, bool attackable) {
+						hash += state::BoardHash::Key(state::BoardHash::kTagMinionAttackable, idx, attackable);
+						++idx;
+						return true;
+					});
+				});
+				return state::BoardHash::Mix(hash);
+			}
+
 		public: // bridge to action analyzer
 			int GetActionsCount(BoardActionAnalyzer & action_analyzer) const
 			{
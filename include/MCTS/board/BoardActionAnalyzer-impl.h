@@ -1,6 +1,6 @@
 #pragma once
 
-#include <set>
+#include <cstdint>
 
 #include "MCTS/board/ActionParameterGetter.h"
 #include "MCTS/board/RandomGenerator.h"
@@ -14,11 +14,11 @@ namespace mcts
 		inline int BoardActionAnalyzer::GetActionsCount(FlowControl::CurrentPlayerStateView const& board)
 		{
 			{
-				std::shared_lock<Utils::SharedSpinLock> lock(mutex_);
+				std::shared_lock<detail::BoardActionAnalyzerLock> lock(mutex_);
 				if (op_map_size_ > 0) return (int)op_map_size_;
 			}
 
-			std::lock_guard<Utils::SharedSpinLock> write_lock(mutex_);
+			std::lock_guard<detail::BoardActionAnalyzerLock> write_lock(mutex_);
 			if (op_map_size_ > 0) return (int)op_map_size_;
 
 			playable_cards_.clear();
@@ -52,7 +52,7 @@ namespace mcts
 		}
 
 		inline Result BoardActionAnalyzer::ApplyAction(FlowControl::FlowContext & flow_context, FlowControl::CurrentPlayerStateView board, int action, IRandomGenerator & random, IRawActionParameterGetter & action_parameters) {
-			std::shared_lock<Utils::SharedSpinLock> lock(mutex_);
+			std::shared_lock<detail::BoardActionAnalyzerLock> lock(mutex_);
 
 			assert(op_map_size_ > 0);
 			assert(action >= 0);
@@ -77,11 +77,12 @@ namespace mcts
 		inline Result BoardActionAnalyzer::Attack(FlowControl::FlowContext & flow_context, FlowControl::CurrentPlayerStateView & board, IRandomGenerator & random, IRawActionParameterGetter & action_parameters)
 		{
 			assert([&]() {
-				std::set<int> current;
-				for (int idx : attackers_) current.insert(idx);
-				std::set<int> checking;
+				// The attacker indics are in [0, 7]. See ValidActionGetter::ForEachAttacker
+				uint32_t current = 0;
+				for (int idx : attackers_) current |= (1u << idx);
+				uint32_t checking = 0;
 				board.ForEachAttacker([&](int idx) {
-					checking.insert(idx);
+					checking |= (1u << idx);
 					return true;
 				});
 				return current == checking;
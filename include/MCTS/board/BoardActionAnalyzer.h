@@ -3,7 +3,7 @@
 #include <shared_mutex>
 #include "MCTS/Types.h"
 #include "FlowControl/PlayerStateView.h"
-#include "Utils/SpinLocks.h"
+#include "MCTS/detail/LockSites.h"
 
 namespace mcts
 {
@@ -54,24 +54,24 @@ namespace mcts
 
 			template <class Functor>
 			void ForEachMainOp(Functor && functor) const {
-				std::shared_lock<Utils::SharedSpinLock> lock(mutex_);
+				std::shared_lock<detail::BoardActionAnalyzerLock> lock(mutex_);
 				for (size_t i = 0; i < op_map_size_; ++i) {
 					if (!functor(i, GetMainOpType(op_map_[i]))) return;
 				}
 			}
 			OpType GetMainOpType(size_t choice) const {
-				std::shared_lock<Utils::SharedSpinLock> lock(mutex_);
+				std::shared_lock<detail::BoardActionAnalyzerLock> lock(mutex_);
 				return GetMainOpType(op_map_[choice]);
 			}
 			template <class Functor>
 			void ForEachPlayableCard(Functor && functor) const {
-				std::shared_lock<Utils::SharedSpinLock> lock(mutex_);
+				std::shared_lock<detail::BoardActionAnalyzerLock> lock(mutex_);
 				for (auto hand_idx : playable_cards_) {
 					if (!functor(hand_idx)) break;
 				}
 			}
 			size_t GetPlaybleCard(size_t idx) const {
-				std::shared_lock<Utils::SharedSpinLock> lock(mutex_);
+				std::shared_lock<detail::BoardActionAnalyzerLock> lock(mutex_);
 				return playable_cards_[idx];
 			}
 
@@ -110,7 +110,7 @@ namespace mcts
 			}
 
 		private:
-			mutable Utils::SharedSpinLock mutex_;
+			mutable detail::BoardActionAnalyzerLock mutex_;
 			std::array<OpFunc, kMaxOpType> op_map_;
 			size_t op_map_size_;
 			std::vector<int> attackers_;
@@ -59,10 +59,12 @@ namespace mcts
 					return true;
 				});
 
+				int opponent_hand_count = 0;
 				board.ForEachOpponentHandCard([&]() {
-					opponent_hand_.emplace_back();
+					++opponent_hand_count;
 					return true;
 				});
+				opponent_hand_.Fill(opponent_hand_count);
 
 				opponent_deck_.Fill(board.GetDeckCardCount(opponent_side));
 			}
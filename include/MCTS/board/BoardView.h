@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstring>
+#include <type_traits>
 #include "state/Types.h"
 #include "FlowControl/PlayerStateView.h"
 #include "MCTS/board/BoardViewTypes.h"
@@ -9,10 +11,9 @@ namespace mcts
 {
 	namespace board
 	{
+		// A fixed-size, trivially-copyable snapshot of the board observed by a player
 		class BoardView
 		{
-			friend std::hash<BoardView>;
-
 		public:
 			template <state::PlayerSide Side>
 			BoardView(FlowControl::PlayerStateView<Side> const& board);
@@ -23,28 +24,10 @@ namespace mcts
 			BoardView & operator=(BoardView const&) = default;
 			BoardView & operator=(BoardView &&) = default;
 
+			// The view has no padding bytes and all unused slots are zero-filled,
+			// so two views are equal iff their bytes are equal
 			bool operator==(BoardView const& rhs) const {
-				static_assert(change_id == 3);
-				if (turn_ != rhs.turn_) return false;
-				if (side_ != rhs.side_) return false;
-
-				if (self_hero_ != rhs.self_hero_) return false;
-				if (self_crystal_ != rhs.self_crystal_) return false;
-				if (self_hero_power_ != rhs.self_hero_power_) return false;
-				if (self_minions_ != rhs.self_minions_) return false;
-				if (self_weapon_ != rhs.self_weapon_) return false;
-				if (self_hand_ != rhs.self_hand_) return false;
-				if (self_deck_ != rhs.self_deck_) return false;
-
-				if (opponent_hero_ != rhs.opponent_hero_) return false;
-				if (opponent_crystal_ != rhs.opponent_crystal_) return false;
-				if (opponent_hero_power_ != rhs.opponent_hero_power_) return false;
-				if (opponent_minions_ != rhs.opponent_minions_) return false;
-				if (opponent_weapon_ != rhs.opponent_weapon_) return false;
-				if (opponent_hand_ != rhs.opponent_hand_) return false;
-				if (opponent_deck_ != rhs.opponent_deck_) return false;
-
-				return true;
+				return std::memcmp(this, &rhs, sizeof(BoardView)) == 0;
 			}
 
 			bool operator!=(BoardView const& rhs) const {
@@ -53,7 +36,7 @@ namespace mcts
 
 		public:
 			int GetTurn() const { return turn_; }
-			state::PlayerSide GetSide() const { return side_; }
+			state::PlayerSide GetSide() const { return (state::PlayerSide)side_; }
 			
 			boardview::SelfHero const& GetSelfHero() const { return self_hero_; }
 			boardview::Crystal const& GetSelfCrystal() const { return self_crystal_; }
@@ -72,10 +55,8 @@ namespace mcts
 			boardview::OpponentDeck const& GetOpponentDeck() const { return opponent_deck_; }
 
 		private:
-			static int constexpr change_id = 3;
-
-			int turn_;
-			state::PlayerSide side_;
+			boardview::Value turn_;
+			boardview::Value side_;
 
 			boardview::SelfHero self_hero_;
 			boardview::Crystal self_crystal_;
@@ -93,6 +74,9 @@ namespace mcts
 			boardview::OpponentHand opponent_hand_;
 			boardview::OpponentDeck opponent_deck_;
 		};
+
+		static_assert(std::is_trivially_copyable_v<BoardView>);
+		static_assert(std::has_unique_object_representations_v<BoardView>);
 	}
 }
 
@@ -101,29 +85,7 @@ namespace std {
 	struct hash<mcts::board::BoardView> {
 		std::size_t operator()(mcts::board::BoardView const& v) const
 		{
-			static_assert(mcts::board::BoardView::change_id == 3);
-
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.turn_);
-			Utils::HashCombine::hash_combine(result, (int)v.side_);
-
-			Utils::HashCombine::hash_combine(result, v.self_hero_);
-			Utils::HashCombine::hash_combine(result, v.self_crystal_);
-			Utils::HashCombine::hash_combine(result, v.self_hero_power_);
-			Utils::HashCombine::hash_combine(result, v.self_minions_);
-			Utils::HashCombine::hash_combine(result, v.self_weapon_);
-			Utils::HashCombine::hash_combine(result, v.self_hand_);
-			Utils::HashCombine::hash_combine(result, v.self_deck_);
-
-			Utils::HashCombine::hash_combine(result, v.opponent_hero_);
-			Utils::HashCombine::hash_combine(result, v.opponent_crystal_);
-			Utils::HashCombine::hash_combine(result, v.opponent_hero_power_);
-			Utils::HashCombine::hash_combine(result, v.opponent_minions_);
-			Utils::HashCombine::hash_combine(result, v.opponent_weapon_);
-			Utils::HashCombine::hash_combine(result, v.opponent_hand_);
-			Utils::HashCombine::hash_combine(result, v.opponent_deck_);
-
-			return result;
+			return (std::size_t)Utils::HashCombine::hash_bytes(&v, sizeof(v));
 		}
 	};
-}
\ No newline at end of file
+}
@@ -1,9 +1,12 @@
 #pragma once
 
-#include <vector>
+#include <assert.h>
+#include <cstdint>
+#include <utility>
 #include "Cards/id-map.h"
 #include "state/Types.h"
-#include "Utils/HashCombine.h"
+#include "state/board/Hand.h"
+#include "state/board/Minions.h"
 
 namespace mcts
 {
@@ -11,498 +14,178 @@ namespace mcts
 	{
 		namespace boardview
 		{
-			struct Hero
+			// All fields are 16-bit integers, so the types have no padding bytes,
+			// and two views can be compared (and hashed) byte by byte.
+			// Unused fields (e.g., an unequipped weapon, or the slots after the
+			// last minion) should be left zero-filled.
+			using Value = std::int16_t;
+
+			// A fixed-capacity list, stored inline
+			template <class T, int Capacity>
+			struct List
 			{
-				// TODO: playerClass
-				int attack;
-				int hp;
-				int max_hp;
-				int armor;
+				Value size;
+				T items[Capacity];
 
-				void Fill(state::Cards::Card const& hero) {
-					attack = hero.GetAttack();
-					hp = hero.GetHP();
-					max_hp = hero.GetMaxHP();
-					armor = hero.GetArmor();
+				template <class... Args>
+				void emplace_back(Args&&... args) {
+					assert(size < Capacity);
+					items[size].Fill(std::forward<Args>(args)...);
+					++size;
 				}
 
-				bool operator==(Hero const& v) const {
-					static_assert(change_id == 1);
-					if (attack != v.attack) return false;
-					if (hp != v.hp) return false;
-					if (max_hp != v.max_hp) return false;
-					if (armor != v.armor) return false;
-					return true;
+				T const& operator[](size_t idx) const {
+					assert(idx < (size_t)size);
+					return items[idx];
 				}
+				T const* begin() const { return items; }
+				T const* end() const { return items + size; }
+			};
 
-				bool operator!=(Hero const& v) const {
-					return !(*this == v);
-				}
+			struct Hero
+			{
+				// TODO: playerClass
+				Value attack;
+				Value hp;
+				Value max_hp;
+				Value armor;
 
-				static int constexpr change_id = 1;
+				void Fill(state::Cards::Card const& hero) {
+					attack = (Value)hero.GetAttack();
+					hp = (Value)hero.GetHP();
+					max_hp = (Value)hero.GetMaxHP();
+					armor = (Value)hero.GetArmor();
+				}
 			};
 
 			struct SelfHero : public Hero
 			{
-				bool attackable;
+				Value attackable;
 
 				void Fill(state::Cards::Card const& hero, bool now_attackable) {
 					Hero::Fill(hero);
 					attackable = now_attackable;
 				}
-
-				bool operator==(SelfHero const& v) const {
-					static_assert(change_id == 1);
-					if (Hero::operator!=(v)) return false;
-					if (attackable != v.attackable) return false;
-					return true;
-				}
-
-				bool operator!=(SelfHero const& v) const {
-					return !(*this == v);
-				}
-
-				static int constexpr change_id = 1;
 			};
 
 			struct Crystal
 			{
-				int current;
-				int total;
-				int overload;
-				int overload_next_turn;
+				Value current;
+				Value total;
+				Value overload;
+				Value overload_next_turn;
 
 				void Fill(state::board::PlayerResource const& resource) {
-					current = resource.GetCurrent();
-					total = resource.GetTotal();
-					overload = resource.GetCurrentOverloaded();
-					overload_next_turn = resource.GetNextOverload();
-				}
-
-				bool operator==(Crystal const& v) const {
-					static_assert(change_id == 1);
-					if (current != v.current) return false;
-					if (total != v.total) return false;
-					if (overload != v.overload) return false;
-					if (overload_next_turn != v.overload_next_turn) return false;
-					return true;
+					current = (Value)resource.GetCurrent();
+					total = (Value)resource.GetTotal();
+					overload = (Value)resource.GetCurrentOverloaded();
+					overload_next_turn = (Value)resource.GetNextOverload();
 				}
-
-				bool operator!=(Crystal const& v) const {
-					return !(*this == v);
-				}
-
-				static int constexpr change_id = 1;
 			};
 
 			struct HeroPower
 			{
-				Cards::CardId card_id;
-				bool usable;
+				Value card_id;
+				Value usable;
 
 				void Fill(state::Cards::Card const& card) {
-					card_id = card.GetCardId();
+					card_id = (Value)card.GetCardId();
 					usable = card.GetRawData().usable; // TOOD: is this accurate?
 				}
-
-				bool operator==(HeroPower const& v) const {
-					static_assert(change_id == 1);
-					if (card_id != v.card_id) return false;
-					if (usable != v.usable) return false;
-					return true;
-				}
-
-				bool operator!=(HeroPower const& v) const {
-					return !(*this == v);
-				}
-
-				static int constexpr change_id = 1;
 			};
 
 			struct Weapon
 			{
-				bool equipped;
-				Cards::CardId card_id;
-				int attack;
-				int durability;
+				Value equipped;
+				Value card_id;
+				Value attack;
+				Value durability;
 
 				void Fill(state::Cards::Card const& card) {
 					equipped = true;
-					card_id = card.GetCardId();
-					attack = card.GetAttack();
-					durability = card.GetHP();
-				}
-
-				void Invalidate() { equipped = false; }
-
-				bool operator==(Weapon const& v) const {
-					static_assert(change_id == 1);
-					if (equipped != v.equipped) return false;
-
-					if (equipped) {
-						if (card_id != v.card_id) return false;
-						if (attack != v.attack) return false;
-						if (durability != v.durability) return false;
-					}
-
-					return true;
-				}
-
-				bool operator!=(Weapon const& v) const {
-					return !(*this == v);
+					card_id = (Value)card.GetCardId();
+					attack = (Value)card.GetAttack();
+					durability = (Value)card.GetHP();
 				}
 
-				static int constexpr change_id = 1;
+				void Invalidate() { *this = Weapon(); }
 			};
 
 			struct Minion
 			{
-				Cards::CardId card_id;
-				int attack;
-				int hp;
-				int max_hp;
-
-				bool silenced;
+				Value card_id;
+				Value attack;
+				Value hp;
+				Value max_hp;
 				// TODO: more flags
-				//   charge, cant_attack, cant_attack_hero, has enchant?, has deathrattle?
-
-				Minion(state::Cards::Card const& card) :
-					card_id(card.GetCardId()),
-					attack(card.GetAttack()),
-					hp(card.GetHP()),
-					max_hp(card.GetMaxHP()),
-					silenced(card.IsSilenced())
-				{
-				}
+				//   silenced, charge, cant_attack, cant_attack_hero, has enchant?, has deathrattle?
 
-				bool operator==(Minion const& v) const {
-					static_assert(change_id == 1);
-					if (card_id != v.card_id) return false;
-					if (attack != v.attack) return false;
-					if (hp != v.hp) return false;
-					if (max_hp != v.max_hp) return false;
-					return true;
-				}
-
-				bool operator!=(Minion const& v) const {
-					return !(*this == v);
+				void Fill(state::Cards::Card const& card) {
+					card_id = (Value)card.GetCardId();
+					attack = (Value)card.GetAttack();
+					hp = (Value)card.GetHP();
+					max_hp = (Value)card.GetMaxHP();
 				}
-
-				static int constexpr change_id = 1;
 			};
 
 			struct SelfMinion : public Minion
 			{
-				bool attackable;
-
-				SelfMinion(state::Cards::Card const& card, bool now_attackable)
-					: Minion(card), attackable(now_attackable)
-				{
-				}
-
-				bool operator==(SelfMinion const& v) const {
-					static_assert(change_id == 1);
-					if (Minion::operator!=(v)) return false;
-					if (attackable != v.attackable) return false;
-					return true;
-				}
+				Value attackable;
 
-				bool operator!=(SelfMinion const& v) const {
-					return !(*this == v);
+				void Fill(state::Cards::Card const& card, bool now_attackable) {
+					Minion::Fill(card);
+					attackable = now_attackable;
 				}
-
-				static int constexpr change_id = 1;
 			};
 
-			using Minions = std::vector<Minion>;
-			using SelfMinions = std::vector<SelfMinion>;
+			using Minions = List<Minion, state::board::Minions::max_size_>;
+			using SelfMinions = List<SelfMinion, state::board::Minions::max_size_>;
 
 			struct SelfHandCard
 			{
-				Cards::CardId card_id;
-				int cost;
-				int attack;
-				int hp;
-
-				SelfHandCard(state::Cards::Card const& card) :
-					card_id(card.GetCardId()),
-					cost(card.GetCost()),
-					attack(card.GetAttack()),
-					hp(card.GetHP())
-				{
-				}
+				Value card_id;
+				Value cost;
+				Value attack;
+				Value hp;
 
-				bool operator==(SelfHandCard const& v) const {
-					static_assert(change_id == 1);
-					if (card_id != v.card_id) return false;
-					if (cost != v.cost) return false;
-					if (attack != v.attack) return false;
-					if (hp != v.hp) return false;
-					return true;
-				}
-
-				bool operator!=(SelfHandCard const& v) const {
-					return !(*this == v);
+				void Fill(state::Cards::Card const& card) {
+					card_id = (Value)card.GetCardId();
+					cost = (Value)card.GetCost();
+					attack = (Value)card.GetAttack();
+					hp = (Value)card.GetHP();
 				}
-
-				static int constexpr change_id = 1;
 			};
-			struct OpponentHandCard
-			{
-				// int hold_from_turn; // TODO
-				// bool enchanted; // TODO
 
-				OpponentHandCard() { Fill(); }
-
-				void Fill() {
-				}
+			using SelfHand = List<SelfHandCard, (int)state::board::Hand::max_cards_>;
 
-				bool operator==(OpponentHandCard const& v) const {
-					static_assert(change_id == 1);
-					return true;
-				}
+			struct OpponentHand
+			{
+				// TODO: hold_from_turn, enchanted for each card
+				Value count;
 
-				bool operator!=(OpponentHandCard const& v) const {
-					return !(*this == v);
+				void Fill(int in_count) {
+					count = (Value)in_count;
 				}
-
-				static int constexpr change_id = 1;
 			};
 
-			using SelfHand = std::vector<SelfHandCard>;
-			using OpponentHand = std::vector<OpponentHandCard>;
-
 			struct SelfDeck
 			{
 				//std::unordered_set<Cards::CardId> cards; // TODO: do we really need this in board view?
-				int count;
+				Value count;
 
 				void Fill(int in_count) {
-					count = in_count;
-				}
-
-				bool operator==(SelfDeck const& v) const {
-					static_assert(change_id == 1);
-					if (count != v.count) return false;
-					return true;
+					count = (Value)in_count;
 				}
-
-				bool operator!=(SelfDeck const& v) const {
-					return !(*this == v);
-				}
-
-				static int constexpr change_id = 1;
 			};
 
 			struct OpponentDeck
 			{
-				size_t count;
+				Value count;
 
 				void Fill(int in_count) {
-					count = in_count;
+					count = (Value)in_count;
 				}
-
-				bool operator==(OpponentDeck const& v) const {
-					static_assert(change_id == 1);
-					if (count != v.count) return false;
-					return true;
-				}
-
-				bool operator!=(OpponentDeck const& v) const {
-					return !(*this == v);
-				}
-
-				static int constexpr change_id = 1;
 			};
 		}
 	}
 }
-
-namespace std {
-	template <>
-	struct hash<mcts::board::boardview::Hero> {
-		std::size_t operator()(mcts::board::boardview::Hero const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.attack);
-			Utils::HashCombine::hash_combine(result, v.hp);
-			Utils::HashCombine::hash_combine(result, v.max_hp);
-			Utils::HashCombine::hash_combine(result, v.armor);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::SelfHero> {
-		std::size_t operator()(mcts::board::boardview::SelfHero const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = std::hash<mcts::board::boardview::Hero>()(v);
-			Utils::HashCombine::hash_combine(result, v.attackable);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::Crystal> {
-		std::size_t operator()(mcts::board::boardview::Crystal const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.current);
-			Utils::HashCombine::hash_combine(result, v.total);
-			Utils::HashCombine::hash_combine(result, v.overload);
-			Utils::HashCombine::hash_combine(result, v.overload_next_turn);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::HeroPower> {
-		std::size_t operator()(mcts::board::boardview::HeroPower const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.card_id);
-			Utils::HashCombine::hash_combine(result, v.usable);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::Weapon> {
-		std::size_t operator()(mcts::board::boardview::Weapon const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.equipped);
-			if (v.equipped) {
-				Utils::HashCombine::hash_combine(result, v.card_id);
-				Utils::HashCombine::hash_combine(result, v.attack);
-				Utils::HashCombine::hash_combine(result, v.durability);
-			}
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::Minion> {
-		std::size_t operator()(mcts::board::boardview::Minion const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.card_id);
-			Utils::HashCombine::hash_combine(result, v.attack);
-			Utils::HashCombine::hash_combine(result, v.hp);
-			Utils::HashCombine::hash_combine(result, v.max_hp);
-			Utils::HashCombine::hash_combine(result, v.silenced);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::SelfMinion> {
-		std::size_t operator()(mcts::board::boardview::SelfMinion const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = std::hash<mcts::board::boardview::Minion>()(v);
-			Utils::HashCombine::hash_combine(result, v.attackable);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::Minions> {
-		std::size_t operator()(mcts::board::boardview::Minions const& v) const
-		{
-			std::size_t result = 0;
-			for (auto const& minion : v) {
-				Utils::HashCombine::hash_combine(result, minion);
-			}
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::SelfMinions> {
-		std::size_t operator()(mcts::board::boardview::SelfMinions const& v) const
-		{
-			std::size_t result = 0;
-			for (auto const& minion : v) {
-				Utils::HashCombine::hash_combine(result, minion);
-			}
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::SelfHandCard> {
-		std::size_t operator()(mcts::board::boardview::SelfHandCard const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.card_id);
-			Utils::HashCombine::hash_combine(result, v.cost);
-			Utils::HashCombine::hash_combine(result, v.attack);
-			Utils::HashCombine::hash_combine(result, v.hp);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::OpponentHandCard> {
-		std::size_t operator()(mcts::board::boardview::OpponentHandCard const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::SelfHand> {
-		std::size_t operator()(mcts::board::boardview::SelfHand const& v) const
-		{
-			std::size_t result = 0;
-			for (auto const& item : v) {
-				Utils::HashCombine::hash_combine(result, item);
-			}
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::OpponentHand> {
-		std::size_t operator()(mcts::board::boardview::OpponentHand const& v) const
-		{
-			std::size_t result = 0;
-			for (auto const& item : v) {
-				Utils::HashCombine::hash_combine(result, item);
-			}
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::SelfDeck> {
-		std::size_t operator()(mcts::board::boardview::SelfDeck const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.count);
-			return result;
-		}
-	};
-
-	template <>
-	struct hash<mcts::board::boardview::OpponentDeck> {
-		std::size_t operator()(mcts::board::boardview::OpponentDeck const& v) const
-		{
-			static_assert(std::decay_t<decltype(v)>::change_id == 1);
-			std::size_t result = 0;
-			Utils::HashCombine::hash_combine(result, v.count);
-			return result;
-		}
-	};
-}
\ No newline at end of file
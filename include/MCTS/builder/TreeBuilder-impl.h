@@ -34,13 +34,31 @@ namespace mcts
 			// we use mutable here, since we will throw it away after all
 			auto & traversed_path = selection_stage_.GetMutableTraversedPath();
 
-			// mark the last action as a redirect node
-			traversed_path.back().ConstructRedirectNode();
-
 			bool new_node_created = false;
+			bool expansion_suspended = false;
+			if (selection_stage_.IsOffTree()) {
+				// the last choice has no edge; the path is updated up to the node before it
+				traversed_path.pop_back();
+				expansion_suspended = true;
+			}
+			else {
+				// mark the last action as a redirect node
+				traversed_path.back().ConstructRedirectNode();
+			}
+
 			if (perform_result.result.type_ == Result::kResultNotDetermined) {
-				perform_result.node = last_node_map.GetOrCreateNode(board, &new_node_created);
-				assert(perform_result.node);
+				if (expansion_suspended) {
+					// off the tree; continue with simulation
+				}
+				else if (budget_->IsExhausted()) {
+					// only follow an existing node
+					perform_result.node = last_node_map.GetNode(board);
+					if (!perform_result.node) expansion_suspended = true;
+				}
+				else {
+					perform_result.node = last_node_map.GetOrCreateNode(board, &new_node_created);
+					assert(perform_result.node);
+				}
 			}
 			else {
 				assert(perform_result.node == nullptr);
@@ -55,12 +73,14 @@ namespace mcts
 				assert(perform_result.node != nullptr);
 			}
 
+			budget_->AddNodes(selection_stage_.GetNewNodesCount() + (new_node_created ? 1 : 0));
+
 			if (!new_node_created) {
 				new_node_created = selection_stage_.HasNewNodeCreated();
 			}
 
 			assert(perform_result.change_to_simulation == false); // default value
-			if (new_node_created) {
+			if (new_node_created || expansion_suspended) {
 				perform_result.change_to_simulation = true;
 			}
 			else if (traversed_path.back().GetEdgeAddon()->GetChosenTimes() < StaticConfigs::kSwitchToSimulationUnderChosenTimes) {
@@ -72,6 +92,7 @@ namespace mcts
 
 			assert([&](builder::TreeBuilder::TreeNode* node) {
 				if (perform_result.result.type_ != Result::kResultNotDetermined) return true;
+				if (!node) return expansion_suspended;
 				if (!node->GetActionType().IsValid()) return true;
 				return node->GetActionType().GetType() == ActionType::kMainAction;
 			}(perform_result.node));
@@ -125,7 +146,7 @@ namespace mcts
 			result = board_->ApplyAction(choice, action_analyzer, flow_context, random_generator_, action_parameter_getter_);
 			assert(result.type_ != Result::kResultInvalid);
 
-			statistic_.ApplyActionSucceeded(is_simulation);
+			statistic_->ApplyActionSucceeded(is_simulation);
 			return result;
 		}
 
@@ -4,6 +4,7 @@
 #include "MCTS/selection/Selection.h"
 #include "MCTS/simulation/Simulation.h"
 #include "MCTS/Statistic.h"
+#include "MCTS/TreeBudget.h"
 #include "MCTS/Types.h"
 #include "MCTS/builder/TreeUpdater.h"
 #include "MCTS/board/Board.h"
@@ -23,19 +24,26 @@ namespace mcts
 			typedef selection::TreeNode TreeNode;
 
 			TreeBuilder(state::PlayerSide side, SOMCTS & caller, Statistic<> & statistic,
-				std::mt19937 & selection_rand, std::mt19937 & simulation_rand)
+				TreeBudget & budget, std::mt19937 & selection_rand, std::mt19937 & simulation_rand)
 				:
-				statistic_(statistic),
+				statistic_(&statistic), budget_(&budget),
 				action_parameter_getter_(caller), random_generator_(caller),
 				board_(nullptr),
 				flow_context_(),
-				selection_stage_(side, selection_rand), simulation_stage_(side, simulation_rand, flow_context_)
+				selection_stage_(side, selection_rand, budget), simulation_stage_(side, simulation_rand, flow_context_)
 			{
 			}
 
 			TreeBuilder(TreeBuilder const&) = delete;
 			TreeBuilder & operator=(TreeBuilder const&) = delete;
 
+			// Should not be called in the middle of an episode
+			void Rebind(Statistic<> & statistic, TreeBudget & budget) {
+				statistic_ = &statistic;
+				budget_ = &budget;
+				selection_stage_.SetBudget(budget);
+			}
+
 			struct SelectResult
 			{
 				Result result; // Never returns kResultInvalid
@@ -68,7 +76,8 @@ namespace mcts
 			int ChooseSimulateAction(ActionType action_type, board::ActionChoices const& choices);
 
 		private:
-			Statistic<> & statistic_;
+			Statistic<> * statistic_;
+			TreeBudget * budget_;
 
 			board::ActionParameterGetter action_parameter_getter_;
 			board::RandomGenerator random_generator_;
@@ -45,6 +45,12 @@ namespace mcts
 					return true;
 				}());
 
+				if (nodes.empty()) {
+					// the main action ended off the tree
+					last_node_ = last_node;
+					return;
+				}
+
 				if (HasLastNode()) {
 					if (nodes.front().GetNode() != last_node_) {
 						nodes_.emplace_back(last_node_);
@@ -113,8 +119,7 @@ namespace mcts
 					auto * edge_addon = item.GetEdgeAddon();
 					if (!edge_addon) continue;
 
-					edge_addon->AddTotal(100);
-					edge_addon->AddCredit((int)(credit * 100.0));
+					edge_addon->AddCreditAndTotal((int)(credit * 100.0), 100);
 				}
 			}
 
@@ -172,8 +177,7 @@ namespace mcts
 						should_visits_.erase(edge_addon);
 						return true;
 					}());
-					edge_addon->AddTotal(100);
-					edge_addon->AddCredit((int)(credit*100.0));
+					edge_addon->AddCreditAndTotal((int)(credit*100.0), 100);
 
 					// use BFS to reduce the lock time
 					node->GetAddon().leading_nodes.ForEachLeadingNode(
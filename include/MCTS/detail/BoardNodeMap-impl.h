@@ -11,17 +11,33 @@ namespace mcts
 	{
 		inline BoardNodeMap::TreeNode* BoardNodeMap::GetOrCreateNode(board::Board const& board, bool * new_node_created)
 		{
-			std::lock_guard<Utils::SharedSpinLock> lock(mutex_);
-
 			if (new_node_created) *new_node_created = false;
 
-			auto & item = GetMap()[board.CreateView()];
-			if (!item) {
-				item.reset(new TreeNode());
-				if (new_node_created) *new_node_created = true;
+			std::uint64_t fingerprint = board.GetFingerprint();
+			Shard & shard = GetShard(fingerprint);
+
+			std::optional<board::BoardView> view;
+			if constexpr (kVerifyBoardView) view.emplace(board.CreateView());
+
+			// Optimistic path: the node usually exists
+			{
+				std::shared_lock<BoardNodeMapLock> lock(shard.mutex);
+				if (TreeNode * node = Find(shard, fingerprint, view ? &*view : nullptr)) return node;
 			}
-			
-			return item.get();
+
+			std::lock_guard<BoardNodeMapLock> lock(shard.mutex);
+			if (TreeNode * node = Find(shard, fingerprint, view ? &*view : nullptr)) return node;
+
+			if (!view) view.emplace(board.CreateView());
+
+			Utils::Arena * arena = Utils::Arena::GetThreadArena();
+			assert(arena);
+			if (!shard.map) shard.map = arena->Create<MapType>();
+
+			Entry * & head = (*shard.map)[fingerprint];
+			head = arena->Create<Entry>(Entry{ std::move(*view), TreeNode::Create(), head });
+			if (new_node_created) *new_node_created = true;
+			return head->node;
 		}
 	}
-}
\ No newline at end of file
+}
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include "MCTS/board/Board.h"
-#include "Utils/SpinLocks.h"
+#include "Utils/Arena.h"
+#include "MCTS/detail/LockSites.h"
 
 namespace mcts
 {
@@ -11,37 +15,173 @@ namespace mcts
 
 	namespace detail
 	{
+		// Thread safety: Yes
+		// The nodes are keyed by the 64-bit fingerprint of the board (see
+		// board::Board::GetFingerprint), and spread over several shards, each
+		// with its own lock.
+		// The full board view is kept in each entry, and compared on lookup, so
+		// a fingerprint collision does not merge two different boards.
+		// A lookup for an existing node only takes a shared lock.
 		class BoardNodeMap
 		{
 		private:
 			using TreeNode = mcts::selection::TreeNode;
-			using MapType = std::unordered_map<board::BoardView, std::unique_ptr<TreeNode>>;
+
+			// Compare the board views on lookup, so a fingerprint collision
+			// does not merge two different boards
+			// Building a view costs about as much as the lookup itself; only
+			// turn it off to measure the fingerprint alone.
+			static constexpr bool kVerifyBoardView = true;
+
+			static constexpr int kShardsBits = 3;
+			static constexpr int kShards = 1 << kShardsBits;
+
+			// Entries with the same fingerprint are chained
+			struct Entry {
+				board::BoardView view;
+				TreeNode * node;
+				Entry * next;
+			};
+
+			// The fingerprint is already well mixed
+			struct FingerprintHash {
+				std::size_t operator()(std::uint64_t v) const { return (std::size_t)v; }
+			};
+
+			// The maps, the entries and the nodes are allocated from the thread arena
+			using MapType = std::unordered_map<std::uint64_t, Entry*,
+				FingerprintHash, std::equal_to<std::uint64_t>,
+				Utils::ArenaAllocator<std::pair<const std::uint64_t, Entry*>>>;
+
+			struct Shard {
+				BoardNodeMapLock mutex;
+				MapType * map;
+			};
 
 		public:
-			BoardNodeMap() : mutex_(), map_() {}
+			BoardNodeMap() : shards_(nullptr) {}
+
+			BoardNodeMap(BoardNodeMap const&) = delete;
+			BoardNodeMap & operator=(BoardNodeMap const&) = delete;
 
 			TreeNode* GetOrCreateNode(board::Board const& board, bool * new_node_created = nullptr);
 
+			// Return nullptr if there's no node for the board
+			TreeNode* GetNode(board::Board const& board) const {
+				Shard * shards = shards_.load(std::memory_order_acquire);
+				if (!shards) return nullptr;
+
+				std::uint64_t fingerprint = board.GetFingerprint();
+				std::optional<board::BoardView> view;
+				if constexpr (kVerifyBoardView) view.emplace(board.CreateView());
+
+				Shard & shard = shards[GetShardIndex(fingerprint)];
+				std::shared_lock<BoardNodeMapLock> lock(shard.mutex);
+				return Find(shard, fingerprint, view ? &*view : nullptr);
+			}
+
+			bool IsEmpty() const {
+				bool empty = true;
+				ForEach([&](board::BoardView const&, TreeNode *) {
+					empty = false;
+					return false;
+				});
+				return empty;
+			}
+
+			// Thread safety: No
+			void Swap(BoardNodeMap & rhs) {
+				Shard * shards = shards_.load(std::memory_order_relaxed);
+				shards_.store(rhs.shards_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				rhs.shards_.store(shards, std::memory_order_relaxed);
+			}
+
 			template <typename Functor>
 			void ForEach(Functor&& functor) const {
-				std::shared_lock<Utils::SharedSpinLock> lock_(mutex_);
+				Shard * shards = shards_.load(std::memory_order_acquire);
+				if (!shards) return;
 
-				if (!map_) return;
-				for (auto const& kv : *map_) {
-					if (!functor(kv.first, kv.second.get())) return;
+				for (int i = 0; i < kShards; ++i) {
+					std::shared_lock<BoardNodeMapLock> lock(shards[i].mutex);
+					if (!shards[i].map) continue;
+					for (auto const& kv : *shards[i].map) {
+						for (Entry const* entry = kv.second; entry; entry = entry->next) {
+							if (!functor(entry->view, entry->node)) return;
+						}
+					}
+				}
+			}
+
+			// Copy the entries of 'rhs' to the thread arena
+			// The nodes are mapped by 'node_mapper' (TreeNode const* -> TreeNode *)
+			// Thread safety: No
+			template <typename NodeMapper>
+			void CopyFrom(BoardNodeMap const& rhs, NodeMapper&& node_mapper) {
+				assert(!shards_.load(std::memory_order_relaxed));
+				Shard * rhs_shards = rhs.shards_.load(std::memory_order_relaxed);
+				if (!rhs_shards) return;
+
+				Utils::Arena * arena = Utils::Arena::GetThreadArena();
+				assert(arena);
+				Shard * shards = CreateShards();
+
+				for (int i = 0; i < kShards; ++i) {
+					if (!rhs_shards[i].map) continue;
+					shards[i].map = arena->Create<MapType>();
+					shards[i].map->reserve(rhs_shards[i].map->size());
+					for (auto const& kv : *rhs_shards[i].map) {
+						Entry * * tail = &(*shards[i].map)[kv.first];
+						for (Entry const* entry = kv.second; entry; entry = entry->next) {
+							*tail = arena->Create<Entry>(Entry{ entry->view, node_mapper(entry->node), nullptr });
+							tail = &(*tail)->next;
+						}
+					}
 				}
 			}
 
 		private:
-			MapType & GetMap()
-			{
-				if (!map_) map_.reset(new MapType());
-				return *map_.get();
+			// 'view' is only needed if kVerifyBoardView is set
+			static TreeNode * Find(Shard const& shard, std::uint64_t fingerprint, board::BoardView const* view) {
+				if (!shard.map) return nullptr;
+				auto it = shard.map->find(fingerprint);
+				if (it == shard.map->end()) return nullptr;
+				if constexpr (!kVerifyBoardView) return it->second->node;
+
+				assert(view);
+				for (Entry const* entry = it->second; entry; entry = entry->next) {
+					if (entry->view == *view) return entry->node;
+				}
+				return nullptr;
+			}
+
+			static int GetShardIndex(std::uint64_t fingerprint) {
+				return (int)(fingerprint >> (64 - kShardsBits));
+			}
+
+			Shard & GetShard(std::uint64_t fingerprint) {
+				Shard * shards = shards_.load(std::memory_order_acquire);
+				if (!shards) shards = CreateShards();
+				return shards[GetShardIndex(fingerprint)];
+			}
+
+			// Several threads might race to create the shards. The losers' shards
+			// are left unused in their arenas.
+			Shard * CreateShards() {
+				Utils::Arena * arena = Utils::Arena::GetThreadArena();
+				assert(arena);
+
+				Shard * shards = static_cast<Shard *>(arena->Allocate(sizeof(Shard) * kShards, alignof(Shard)));
+				for (int i = 0; i < kShards; ++i) new (&shards[i]) Shard{ {}, nullptr };
+
+				Shard * expected = nullptr;
+				if (shards_.compare_exchange_strong(expected, shards, std::memory_order_acq_rel)) {
+					return shards;
+				}
+				return expected;
 			}
 
 		private:
-			mutable Utils::SharedSpinLock mutex_;
-			std::unique_ptr<MapType> map_;
+			std::atomic<Shard *> shards_;
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "Utils/SpinLocks.h"
+
+namespace mcts
+{
+	namespace detail
+	{
+		// Counts the contended lock acquisitions of a lock site
+		// Only the slow path touches the counter
+		template <class Site>
+		class SiteContentionRecorder
+		{
+		public:
+			static void ReportContention() {
+				counter_.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			static std::uint64_t GetContentions() {
+				return counter_.load(std::memory_order_relaxed);
+			}
+
+		private:
+			static inline std::atomic<std::uint64_t> counter_{ 0 };
+		};
+
+		struct BoardNodeMapSite {};
+		struct ChildNodeMapSite {}; // lock-free; counts waits for a racing publisher
+		struct BoardActionAnalyzerSite {};
+		struct TreeNodeLeadingNodesSite {};
+
+		using BoardNodeMapLock = Utils::BasicSharedSpinLock<SiteContentionRecorder<BoardNodeMapSite>>;
+		using BoardActionAnalyzerLock = Utils::BasicSharedSpinLock<SiteContentionRecorder<BoardActionAnalyzerSite>>;
+		using TreeNodeLeadingNodesLock = Utils::BasicSharedSpinLock<SiteContentionRecorder<TreeNodeLeadingNodesSite>>;
+	}
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "MCTS/board/Board.h"
+#include "MCTS/selection/TreeNode.h"
+#include "MCTS/detail/BoardNodeMap-impl.h"
+
+namespace mcts
+{
+	namespace detail
+	{
+		// Reuse a search tree after the game moves on
+		// The node of the new board is located through the board node maps, and
+		// it becomes the new root. The rest of the tree is detached from it.
+		// Thread safety: No. The tree should not be searched at the same time.
+		class RootPromoter
+		{
+		private:
+			using TreeNode = selection::TreeNode;
+
+		public:
+			// The board node map of a turn-start node holds
+			//    the boards after each main action in the turn (depth 1)
+			//    the boards at the end of the turn, whose board node maps hold
+			//    the boards at the start of the next turn (depth 2)
+			static constexpr int kMaxDepth = 2;
+
+			struct FindResult {
+				TreeNode * node;
+				int depth;
+			};
+
+			// Return a nullptr node if not found
+			static FindResult FindNode(TreeNode * root, board::Board const& board) {
+				std::vector<TreeNode *> current{ root };
+				std::vector<TreeNode *> next;
+				for (int depth = 1; depth <= kMaxDepth; ++depth) {
+					for (TreeNode * node : current) {
+						TreeNode * found = node->GetAddon().board_node_map.GetNode(board);
+						if (found) return { found, depth };
+					}
+
+					next.clear();
+					for (TreeNode * node : current) {
+						node->GetAddon().board_node_map.ForEach([&](board::BoardView const&, TreeNode * child) {
+							next.push_back(child);
+							return true;
+						});
+					}
+					current.swap(next);
+				}
+				return { nullptr, 0 };
+			}
+
+			// The new root is in the returned node; nullptr if the board is not in the tree
+			static FindResult Promote(TreeNode * root, board::Board const& board) {
+				FindResult result = FindNode(root, board);
+				if (!result.node) return result;
+
+				if (result.depth == 1) {
+					// In the middle of a turn. The boards after the following main
+					// actions are still kept in the map of the turn-start node.
+					assert(result.node->GetAddon().board_node_map.IsEmpty());
+					result.node->GetAddon().board_node_map.Swap(root->GetAddon().board_node_map);
+				}
+
+				Detach(result.node);
+				return result;
+			}
+
+			// Remove the links from the unreachable nodes, so the win rates are
+			// no longer propagated to them
+			// The memory of the unreachable nodes is kept in the arenas (see CopyTree).
+			static void Detach(TreeNode * new_root) {
+				std::unordered_set<TreeNode *> reachable = GetReachableNodes(new_root);
+				for (TreeNode * node : reachable) {
+					node->GetAddon().leading_nodes.RemoveIf([&](TreeNode * leading_node, int) {
+						return reachable.find(leading_node) == reachable.end();
+					});
+				}
+			}
+
+			static size_t CountNodes(TreeNode * root) {
+				return GetReachableNodes(root).size();
+			}
+
+			// Copy the nodes reachable from 'root' to the thread arena, and return
+			// the new root
+			// The old nodes are left untouched, so their arenas can be released
+			// afterwards, together with the unreachable nodes in them.
+			static TreeNode * CopyTree(TreeNode * root) {
+				std::unordered_set<TreeNode *> reachable = GetReachableNodes(root);
+
+				std::unordered_map<TreeNode const*, TreeNode *> copies;
+				copies.reserve(reachable.size());
+				for (TreeNode * node : reachable) {
+					copies.emplace(node, TreeNode::Create());
+				}
+
+				// the leading nodes might be unreachable; they are dropped
+				auto node_mapper = [&](TreeNode const* node) -> TreeNode * {
+					if (!node) return nullptr;
+					if (node->IsWinLossNode()) return const_cast<TreeNode *>(node);
+					auto it = copies.find(node);
+					if (it == copies.end()) return nullptr;
+					return it->second;
+				};
+
+				for (auto const& kv : copies) {
+					kv.second->CopyFrom(*kv.first, node_mapper);
+				}
+				return copies[root];
+			}
+
+		private:
+			static std::unordered_set<TreeNode *> GetReachableNodes(TreeNode * root) {
+				std::unordered_set<TreeNode *> reachable;
+				std::vector<TreeNode *> bfs{ root };
+				reachable.insert(root);
+
+				auto visit = [&](TreeNode * node) {
+					if (!node || node->IsWinNode() || node->IsLossNode()) return;
+					if (reachable.insert(node).second) bfs.push_back(node);
+				};
+
+				while (!bfs.empty()) {
+					TreeNode * node = bfs.back();
+					bfs.pop_back();
+
+					node->ForEachChild([&](int, selection::ChildType const& child) {
+						visit(child.GetNode());
+						return true;
+					});
+					node->GetAddon().board_node_map.ForEach([&](board::BoardView const&, TreeNode * child) {
+						visit(child);
+						return true;
+					});
+				}
+				return reachable;
+			}
+		};
+	}
+}
@@ -97,8 +97,10 @@ namespace mcts
 
 					// Phase 2: use UCB to make a choice
 					auto get_score = [total_chosen_times](Item const& item) {
-						auto total = item.edge_addon->GetTotal();
-						auto wins = item.edge_addon->GetCredit();
+						// credit and total are read at the same instant
+						auto win_rate = item.edge_addon->GetWinRate();
+						auto total = win_rate.total;
+						auto wins = win_rate.credit;
 						assert(total > 0);
 						assert(wins <= total);
 						double exploit_score = ((double)wins) / total;
@@ -1,8 +1,12 @@
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include "MCTS/detail/LockSites.h"
 #include "MCTS/selection/EdgeAddon.h"
+#include "Utils/Arena.h"
 
 namespace mcts
 {
@@ -12,105 +16,254 @@ namespace mcts
 
 		// Note: after a new node is created, the node should not be deleted
 		// Since another thread might investigating that node (or its children)
+		// The node is owned by the arena of the thread creating it
 		// Thread safety:
 		//    Can be read from several threads concurrently
-		//    Can only be write from one thread
+		//    Is published (SetNode or SetAsRedirectNode) exactly once,
+		//      by the thread claiming the slot in ChildNodeMap
 		class ChildType
 		{
 		private:
 			enum Type {
+				kNotPublished,
 				kNormal,
 				kRedirect
 			};
 
 		public:
-			ChildType() : edge_addon_(), type_(kNormal), node_() {}
+			ChildType() : edge_addon_(), type_(kNotPublished), node_(nullptr) {}
 
 			ChildType(ChildType const&) = delete;
 			ChildType & operator=(ChildType const&) = delete;
 
 			EdgeAddon & GetEdgeAddon() { return edge_addon_; }
 			EdgeAddon const& GetEdgeAddon() const { return edge_addon_; }
-			
-			void SetNode(std::unique_ptr<TreeNode> node) {
-				assert(!node_);
-				assert(type_ == kNormal);
 
+			void SetNode(TreeNode * node) {
+				assert(!IsPublished());
 				assert(node);
-				node_ = std::move(node);
+				node_.store(node, std::memory_order_relaxed);
+				type_.store(kNormal, std::memory_order_release);
 			}
 
 			void SetAsRedirectNode() {
-				assert(!node_);
-				assert(type_ == kNormal || type_ == kRedirect);
-
-				type_ = kRedirect;
+				assert(!IsPublished());
+				type_.store(kRedirect, std::memory_order_release);
 			}
 
-			bool IsRedirectNode() const { return type_ == kRedirect; }
+			bool IsPublished() const { return type_.load(std::memory_order_acquire) != kNotPublished; }
+			bool IsRedirectNode() const { return type_.load(std::memory_order_acquire) == kRedirect; }
 
 			// return nullptr for redirect/invalid nodes
 			TreeNode * GetNode() const {
-				if (type_ == kNormal) return node_.get();
+				if (type_.load(std::memory_order_acquire) == kNormal) {
+					return node_.load(std::memory_order_relaxed);
+				}
 				else return nullptr;
 			}
 
 		private:
 			EdgeAddon edge_addon_;
-			Type type_; // TODO: atomic?
-			std::unique_ptr<TreeNode> node_; // TODO: atomic?
+			std::atomic<Type> type_;
+			std::atomic<TreeNode *> node_;
 		};
 
 		// Thread safety:
-		//    Multiple threads can read (including both Get()) concurrently.
-		//    Should be modified by only one thread
+		//    Lock-free. Readers never block.
+		//    A slot is claimed by a CAS on its key, and then published by its ChildType.
+		//    Slots are claimed in order, so the claimed slots always form a prefix;
+		//    a reader stops at the first unclaimed slot.
+		//    A claimed but not yet published slot is treated as absent by Get() and ForEach().
+		//    A writer racing on the same choice waits (shortly) for it to be published.
 		class ChildNodeMap
 		{
+		private:
+			static constexpr int kUnclaimedKey = -1;
+
+			// A chunk of children. The keys are stored contiguously, so a lookup
+			// is a linear scan over a few cache lines.
+			struct Segment {
+				int capacity;
+				std::atomic<int> * keys;
+				ChildType * children;
+				std::atomic<Segment *> next;
+			};
+
 		public:
-			// Hash table is used here, since
+			// A linear table is used here, since
 			//   1. we don't know the total choices in advance
 			//   2. the key is 'choice', which might be card id for choose-one action
-			using ChildMapType = std::unordered_map<int, ChildType>;
+			//   3. most nodes have only a few children
+			// The first kInlineSize children are stored in the node itself. The rest
+			// are stored in overflow segments (doubling in size) allocated from
+			// the thread arena. Elements are never moved, so a ChildType pointer
+			// stays valid for the lifetime of the tree.
+			static constexpr int kInlineSize = 4;
+			static constexpr int kFirstSegmentSize = 8;
+
+			static_assert(std::is_trivially_destructible_v<ChildType>);
+
+			// Two children per cache line; the inline children are aligned to a
+			// cache line, so the UCB scan over them touches as few lines as possible
+			static constexpr size_t kCacheLineSize = 64;
+			static_assert(kCacheLineSize % sizeof(ChildType) == 0);
+
+			ChildNodeMap() : inline_keys_(), first_segment_(nullptr), inline_children_()
+			{
+				for (auto & key : inline_keys_) key.store(kUnclaimedKey, std::memory_order_relaxed);
+			}
 
-			ChildNodeMap() : map_() {}
+			ChildNodeMap(ChildNodeMap const&) = delete;
+			ChildNodeMap & operator=(ChildNodeMap const&) = delete;
 
+			// return nullptr if the child does not exist, or is not yet published
 			ChildType * Get(int choice) {
-				auto it = map_.find(choice);
-				if (it == map_.end()) return nullptr;
-				return &(it->second);
+				return const_cast<ChildType *>(
+					static_cast<ChildNodeMap const*>(this)->Get(choice));
 			}
 
 			ChildType const* Get(int choice) const {
-				auto it = map_.find(choice);
-				if (it == map_.end()) return nullptr;
-				return &(it->second);
+				ChildType const* child = nullptr;
+				ForEachSlot([&](std::atomic<int> const& key, ChildType const& slot) {
+					int v = key.load(std::memory_order_acquire);
+					if (v == kUnclaimedKey) return false;
+					if (v != choice) return true;
+					if (slot.IsPublished()) child = &slot;
+					return false;
+				});
+				return child;
 			}
 
+			// Return the child of 'choice'. If it does not exist, claim a slot
+			// and publish it with a node from 'node_creator'.
 			// Once a child is created, it should not be destroyed
 			// Since it might still be used in another thread
-			ChildType* CreateNewNode(int choice, std::unique_ptr<TreeNode> node) {
-				assert(map_.find(choice) == map_.end());
-				ChildType & child = map_[choice];
-				child.SetNode(std::move(node));
-				return &child;
+			template <class NodeCreator>
+			ChildType* GetOrCreateNode(int choice, NodeCreator && node_creator, bool * just_created) {
+				return GetOrClaim(choice, [&](ChildType & child) {
+					child.SetNode(node_creator());
+				}, just_created);
 			}
 
-			ChildType* CreateRedirectNode(int choice) {
-				assert(map_.find(choice) == map_.end());
-				ChildType & child = map_[choice];
-				child.SetAsRedirectNode();
-				return &child;
+			ChildType* GetOrCreateRedirectNode(int choice) {
+				return GetOrClaim(choice, [](ChildType & child) {
+					child.SetAsRedirectNode();
+				}, nullptr);
 			}
 
 			template <typename Functor>
 			void ForEach(Functor&& functor) const {
-				for (auto const& kv : map_) {
-					if (!functor(kv.first, kv.second)) return;
+				ForEachSlot([&](std::atomic<int> const& key, ChildType const& slot) {
+					int v = key.load(std::memory_order_acquire);
+					if (v == kUnclaimedKey) return false;
+					if (!slot.IsPublished()) return true;
+					return (bool)functor(v, slot);
+				});
+			}
+
+		private:
+			// functor(key, child) -> continue or not
+			template <typename Functor>
+			void ForEachSlot(Functor&& functor) const {
+				for (int i = 0; i < kInlineSize; ++i) {
+					if (!functor(inline_keys_[i], inline_children_[i])) return;
+				}
+
+				for (Segment const* segment = first_segment_.load(std::memory_order_acquire);
+					segment;
+					segment = segment->next.load(std::memory_order_acquire))
+				{
+					for (int i = 0; i < segment->capacity; ++i) {
+						if (!functor(segment->keys[i], segment->children[i])) return;
+					}
+				}
+			}
+
+			static bool TryClaim(std::atomic<int> & key, int choice, bool & found) {
+				int v = key.load(std::memory_order_acquire);
+				if (v == kUnclaimedKey) {
+					if (key.compare_exchange_strong(v, choice, std::memory_order_acq_rel)) {
+						return true;
+					}
+					// v is reloaded by the failed CAS
+				}
+				found = (v == choice);
+				return false;
+			}
+
+			static ChildType * WaitPublished(ChildType & child) {
+				if (child.IsPublished()) return &child;
+
+				detail::SiteContentionRecorder<detail::ChildNodeMapSite>::ReportContention();
+				Utils::SpinBackoff backoff;
+				while (!child.IsPublished()) backoff.Pause();
+				return &child;
+			}
+
+			template <typename Publisher>
+			ChildType * GetOrClaim(int choice, Publisher && publisher, bool * just_created) {
+				assert(choice != kUnclaimedKey);
+				if (just_created) *just_created = false;
+
+				auto claim_in = [&](std::atomic<int> & key, ChildType & child) -> ChildType * {
+					bool found = false;
+					if (TryClaim(key, choice, found)) {
+						publisher(child);
+						if (just_created) *just_created = true;
+						return &child;
+					}
+					if (found) return WaitPublished(child);
+					return nullptr;
+				};
+
+				for (int i = 0; i < kInlineSize; ++i) {
+					if (auto * child = claim_in(inline_keys_[i], inline_children_[i])) return child;
+				}
+
+				std::atomic<Segment *> * next = &first_segment_;
+				int capacity = kFirstSegmentSize;
+				while (true) {
+					Segment * segment = next->load(std::memory_order_acquire);
+					if (!segment) segment = AppendSegment(*next, capacity);
+
+					for (int i = 0; i < segment->capacity; ++i) {
+						if (auto * child = claim_in(segment->keys[i], segment->children[i])) return child;
+					}
+
+					next = &segment->next;
+					capacity = segment->capacity * 2;
+				}
+			}
+
+			// Several threads might race to append a segment. The losers' segments are
+			// left unused in their arenas.
+			static Segment * AppendSegment(std::atomic<Segment *> & next, int capacity) {
+				Utils::Arena * arena = Utils::Arena::GetThreadArena();
+				assert(arena);
+
+				Segment * segment = arena->Create<Segment>();
+				segment->capacity = capacity;
+				segment->keys = static_cast<std::atomic<int> *>(
+					arena->Allocate(sizeof(std::atomic<int>) * capacity, alignof(std::atomic<int>)));
+				segment->children = static_cast<ChildType *>(
+					arena->Allocate(sizeof(ChildType) * capacity, kCacheLineSize));
+				for (int i = 0; i < capacity; ++i) {
+					new (&segment->keys[i]) std::atomic<int>(kUnclaimedKey);
+					new (&segment->children[i]) ChildType();
+				}
+				segment->next.store(nullptr, std::memory_order_relaxed);
+
+				Segment * expected = nullptr;
+				if (next.compare_exchange_strong(expected, segment, std::memory_order_acq_rel)) {
+					return segment;
 				}
+				return expected;
 			}
 
 		private:
-			ChildMapType map_;
+			std::atomic<int> inline_keys_[kInlineSize];
+			std::atomic<Segment *> first_segment_;
+			alignas(kCacheLineSize) ChildType inline_children_[kInlineSize];
 		};
 	}
-}
\ No newline at end of file
+}
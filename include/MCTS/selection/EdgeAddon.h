@@ -1,36 +1,83 @@
 #pragma once
 
+#include <assert.h>
 #include <atomic>
-#include <stdint.h>
+#include <cstdint>
 
 namespace mcts
 {
 	namespace selection
 	{
 		// Thread safety:
-		//    Can be read from several threads concurrently
-		//    Can only be write from one thread
+		//    Can be read and written from several threads concurrently
+		//    The credit and the total are packed in a single word, so they are
+		//    updated (and read) together with a single atomic operation
+		// The counters are 32-bit unsigned. The credit and the total are scaled
+		// by 100 per update (see TreeUpdater). Once the total reaches
+		// kHalvingTotal (about 20 million updates), both are halved, so the total
+		// never carries into the credit. The win rate is kept, but the later
+		// updates weigh more. This matters for the edges kept across moves, or
+		// grown in a long ponder.
 		class EdgeAddon
 		{
 		public:
-			EdgeAddon() : chosen_times(0), credit(0), total(0) {}
+			static constexpr std::uint64_t kHalvingTotal = (std::uint64_t)1 << 31;
 
-			void AddChosenTimes(int v) { chosen_times += v; }
-			auto GetChosenTimes() const { return chosen_times.load(); }
+			struct WinRate {
+				std::int64_t credit;
+				std::int64_t total;
+			};
 
-			void AddTotal(int v) { total += v; }
-			auto GetTotal() const { return total.load(); }
+			EdgeAddon() : win_rate_(0), chosen_times_(0) {}
 
-			void AddCredit(int v) { credit += v; }
-			auto GetCredit() const { return credit.load(); }
+			void AddChosenTimes(int v) {
+				chosen_times_.fetch_add((std::uint32_t)v, std::memory_order_relaxed);
+			}
+			std::int64_t GetChosenTimes() const {
+				return chosen_times_.load(std::memory_order_relaxed);
+			}
 
-		private:
-			std::atomic<std::int64_t> chosen_times;
+			// 'total' might be negative (e.g., to remove a virtual loss), but the
+			// resulting total should not be
+			void AddCreditAndTotal(int credit, int total) {
+				assert(credit >= 0);
+				std::uint64_t old_value = win_rate_.fetch_add(
+					((std::uint64_t)credit << 32) + (std::uint64_t)(std::int64_t)total,
+					std::memory_order_relaxed);
+
+				std::int64_t new_total = (std::int64_t)(old_value & 0xFFFFFFFFu) + total;
+				assert(new_total >= 0 && new_total < ((std::int64_t)1 << 32)); // no carry or borrow
+				if ((std::uint64_t)new_total >= kHalvingTotal) Halve();
+			}
+			void AddTotal(int v) { AddCreditAndTotal(0, v); }
+			void AddCredit(int v) { AddCreditAndTotal(v, 0); }
+
+			WinRate GetWinRate() const {
+				std::uint64_t v = win_rate_.load(std::memory_order_relaxed);
+				return WinRate{ (std::int64_t)(v >> 32), (std::int64_t)(v & 0xFFFFFFFFu) };
+			}
+			std::int64_t GetTotal() const { return GetWinRate().total; }
+			std::int64_t GetCredit() const { return GetWinRate().credit; }
 
-			// for win-rate
-			std::atomic<std::int64_t> credit;
-			std::atomic<std::int64_t> total;
+			// Thread safety: No (e.g., to copy a tree, see RootPromoter::CopyTree)
+			void CopyFrom(EdgeAddon const& rhs) {
+				win_rate_.store(rhs.win_rate_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				chosen_times_.store(rhs.chosen_times_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+
+		private:
+			// Several threads might cross the threshold together; only one halves
+			void Halve() {
+				std::uint64_t v = win_rate_.load(std::memory_order_relaxed);
+				while ((v & 0xFFFFFFFFu) >= kHalvingTotal) {
+					std::uint64_t halved = (((v >> 32) >> 1) << 32) | ((v & 0xFFFFFFFFu) >> 1);
+					if (win_rate_.compare_exchange_weak(v, halved, std::memory_order_relaxed)) break;
+				}
+			}
 
+			// credit in the higher 32 bits; total in the lower 32 bits
+			std::atomic<std::uint64_t> win_rate_;
+			std::atomic<std::uint32_t> chosen_times_;
 		};
 	}
-}
\ No newline at end of file
+}
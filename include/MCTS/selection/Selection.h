@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include "MCTS/Config.h"
+#include "MCTS/TreeBudget.h"
 #include "MCTS/selection/TreeNode.h"
 #include "MCTS/selection/TraversedNodeInfo.h"
 
@@ -14,19 +15,22 @@ namespace mcts
 		class Selection
 		{
 		public:
-			Selection(state::PlayerSide side, std::mt19937 & rand) :
-				side_(side),
-				path_(), random_(rand), policy_(side), new_node_created_(false), pending_randoms_(false)
+			Selection(state::PlayerSide side, std::mt19937 & rand, TreeBudget const& budget) :
+				side_(side), budget_(&budget),
+				path_(), random_(rand), policy_(side), new_nodes_(0), pending_randoms_(false), off_tree_(false)
 			{}
 
 			Selection(Selection const&) = delete;
 			Selection & operator=(Selection const&) = delete;
 
+			void SetBudget(TreeBudget const& budget) { budget_ = &budget; }
+
 			void StartNewMainAction(TreeNode * root) {
 				path_.clear();
 				path_.emplace_back(root);
-				new_node_created_ = false;
+				new_nodes_ = 0;
 				pending_randoms_ = false;
+				off_tree_ = false;
 			}
 
 			// @return >= 0 for the chosen action
@@ -44,10 +48,21 @@ namespace mcts
 				}
 
 				assert(action_type.IsChosenManually());
+				if (off_tree_) return ChooseOffTree(choices);
+
 				assert(!path_.empty());
 				if (path_.back().HasMadeChoice()) {
-					TreeNode* new_node = path_.back().ConstructNextNode(&new_node_created_);
+					if (budget_->IsExhausted() && !path_.back().GetNextNode()) {
+						// The tree is not expanded any more. The rest of the sub-actions
+						// are chosen randomly, and the main action ends off the tree.
+						off_tree_ = true;
+						return ChooseOffTree(choices);
+					}
+
+					bool new_node_created = false;
+					TreeNode* new_node = path_.back().ConstructNextNode(&new_node_created);
 					assert(new_node);
+					if (new_node_created) ++new_nodes_;
 					path_.emplace_back(new_node);
 				}
 
@@ -100,15 +115,30 @@ namespace mcts
 			std::vector<TraversedNodeInfo> const& GetTraversedPath() const { return path_; }
 			std::vector<TraversedNodeInfo> & GetMutableTraversedPath() { return path_; }
 
-			bool HasNewNodeCreated() const { return new_node_created_; }
+			bool HasNewNodeCreated() const { return new_nodes_ > 0; }
+			int GetNewNodesCount() const { return new_nodes_; }
+
+			// The last choice in the path leads to a node which is not created
+			bool IsOffTree() const { return off_tree_; }
+
+		private:
+			int ChooseOffTree(board::ActionChoices choices) {
+				int idx = random_.GetRandom(choices.Size());
+				choices.Begin();
+				for (int i = 0; i < idx; ++i) choices.StepNext();
+				assert(!choices.IsEnd());
+				return choices.Get();
+			}
 
 		private:
 			state::PlayerSide side_;
+			TreeBudget const* budget_;
 			std::vector<TraversedNodeInfo> path_;
 			StaticConfigs::SelectionPhaseRandomActionPolicy random_;
 			StaticConfigs::SelectionPhaseSelectActionPolicy policy_;
-			bool new_node_created_;
+			int new_nodes_; // created in this main action
 			bool pending_randoms_;
+			bool off_tree_;
 		};
 	}
 }
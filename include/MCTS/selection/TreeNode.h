@@ -10,7 +10,7 @@
 #include "MCTS/board/ActionChoices.h"
 #include "MCTS/selection/EdgeAddon.h"
 #include "MCTS/selection/ChildNodeMap.h"
-#include "Utils/SpinLocks.h"
+#include "Utils/Arena.h"
 
 namespace mcts
 {
@@ -19,7 +19,7 @@ namespace mcts
 		class TreeNode
 		{
 		public:
-			// Note: only calls children's Get(), so a caller can acquire a read-lock only
+			// Note: only calls children's Get(), which never blocks
 			class ChoiceIterator {
 			public:
 				ChoiceIterator(board::ActionChoices & choices, ChildNodeMap & children) :
@@ -62,20 +62,24 @@ namespace mcts
 
 		public:
 			// Thread safety:
-			//   the ChildNodeMap is not thread-safe
-			//   the element ChildType within ChildNodeMap is also not thread-safe
-			//   we use a read-write lock on ChildNodeMap
-			//      if calling only Get(), we can acquire read lock only
-			//      otherwise, need write lock
-			//   Also, the element ChildType in ChildNodeMap will never be removed
+			//   the ChildNodeMap is lock-free (see ChildNodeMap)
+			//   the element ChildType in ChildNodeMap will never be removed
 			//   And thus, the EdgeAddon of ChildType will never be removed
 
 			TreeNode() : 
 				action_type_(ActionType::kInvalid),
 				choices_type_(board::ActionChoices::kInvalid),
-				children_mutex_(), children_(), addon_()
+				children_(), addon_()
 			{}
 
+			// Nodes are allocated from the arena of the calling thread,
+			// and released all together when the arena is cleared
+			static TreeNode * Create() {
+				Utils::Arena * arena = Utils::Arena::GetThreadArena();
+				assert(arena);
+				return arena->Create<TreeNode>();
+			}
+
 			// it is assumed we will never create a node at these special addresses
 			static TreeNode* GetWinNode() { return reinterpret_cast<TreeNode *>(0x1); }
 			static TreeNode* GetLossNode() { return reinterpret_cast<TreeNode *>((uint64_t)0x2); }
@@ -114,9 +118,6 @@ namespace mcts
 					assert(action_type_loaded == action_type.GetType());
 				}
 
-				// We can only acquire a shared lock,
-				// since ChoiceIterator only calls children_.Get()
-				std::shared_lock<Utils::SharedSpinLock> lock(children_mutex_);
 				return select_callback.SelectChoice(
 					ChoiceIterator(choices, children_)
 				);
@@ -131,26 +132,13 @@ namespace mcts
 			// If it's a redirect node, we should follow it by board view, not by choice
 			FollowStatus FollowChoice(int choice)
 			{
-				// Optimize to only acquire a read lock if no need to create a new node
-
-				std::shared_lock<Utils::SharedSpinLock> lock(children_mutex_);
 				ChildType* child = children_.Get(choice);
 
 				bool just_expanded = false;
 				if (!child) {
-					lock.unlock();
-
-					{
-						std::lock_guard<Utils::SharedSpinLock> write_lock(children_mutex_);
-						child = children_.Get(choice);
-						if (!child) {
-							child = children_.CreateNewNode(choice, std::make_unique<TreeNode>());
-							just_expanded = true;
-						}
-					}
-
-					lock.lock();
-					assert(children_.Get(choice)); // a child should never be removed by any thread
+					child = children_.GetOrCreateNode(choice, []() {
+						return Create();
+					}, &just_expanded);
 				}
 
 				// Since a redirect node should only appear at the end of a main-action-sequence,
@@ -164,28 +152,21 @@ namespace mcts
 
 			EdgeAddon& MarkChoiceRedirect(int choice)
 			{
-				// Need a write lock since we modify child state
-				std::lock_guard<Utils::SharedSpinLock> lock(children_mutex_);
-
 				// the child node is not yet created
 				// since we delay the node creation as late as possible
 				ChildType* child = children_.Get(choice);
-				if (!child) child = children_.CreateRedirectNode(choice);
+				if (!child) child = children_.GetOrCreateRedirectNode(choice);
 				assert(child);
 				return child->GetEdgeAddon();
 			}
 
 			EdgeAddon * GetEdgeAddon(int choice) {
-				std::shared_lock<Utils::SharedSpinLock> lock(children_mutex_);
-
 				ChildType * child = children_.Get(choice);
 				if (!child) return nullptr;
 				return &child->GetEdgeAddon();
 			}
 
 			EdgeAddon const* GetEdgeAddon(int choice) const {
-				std::shared_lock<Utils::SharedSpinLock> lock(children_mutex_);
-
 				ChildType const* child = children_.Get(choice);
 				if (!child) return nullptr;
 				return &child->GetEdgeAddon();
@@ -193,11 +174,36 @@ namespace mcts
 
 			template <typename Functor>
 			void ForEachChild(Functor&& functor) const {
-				std::shared_lock<Utils::SharedSpinLock> lock(children_mutex_);
-
 				children_.ForEach(std::forward<Functor>(functor));
 			}
 
+			// Copy the node, with its children and addon
+			// The nodes referred are mapped by 'node_mapper' (TreeNode const* -> TreeNode *);
+			// the children and the board node maps should all be mapped.
+			// New children tables are allocated from the thread arena.
+			// Thread safety: No (see RootPromoter::CopyTree)
+			template <class NodeMapper>
+			void CopyFrom(TreeNode const& rhs, NodeMapper && node_mapper) {
+				action_type_.store(rhs.action_type_.load());
+				choices_type_.store(rhs.choices_type_.load());
+
+				rhs.children_.ForEach([&](int choice, ChildType const& rhs_child) {
+					ChildType * child = nullptr;
+					if (rhs_child.IsRedirectNode()) {
+						child = children_.GetOrCreateRedirectNode(choice);
+					}
+					else {
+						child = children_.GetOrCreateNode(choice, [&]() {
+							return node_mapper(rhs_child.GetNode());
+						}, nullptr);
+					}
+					child->GetEdgeAddon().CopyFrom(rhs_child.GetEdgeAddon());
+					return true;
+				});
+
+				addon_.CopyFrom(rhs.addon_, node_mapper);
+			}
+
 		public:
 			ActionType GetActionType() const {
 				return ActionType(action_type_.load());
@@ -214,12 +220,16 @@ namespace mcts
 				if (!item) return nullptr;
 				return item->GetNode();
 			}
+			TreeNode const* GetChildNode(int choice) const {
+				auto item = children_.Get(choice);
+				if (!item) return nullptr;
+				return item->GetNode();
+			}
 
 		private:
 			std::atomic<ActionType::Types> action_type_;
 			std::atomic<board::ActionChoices::Type> choices_type_; // TODO: debug only
 
-			mutable Utils::SharedSpinLock children_mutex_;
 			ChildNodeMap children_;
 
 			TreeNodeAddon addon_;
@@ -5,6 +5,7 @@
 #include "MCTS/board/BoardView.h"
 #include "MCTS/board/ActionChoices.h"
 #include "Utils/HashCombine.h"
+#include "MCTS/detail/LockSites.h"
 #include "Utils/SpinLocks.h"
 
 namespace mcts
@@ -72,6 +73,13 @@ namespace mcts
 				return board_view_.get();
 			}
 
+			// Thread safety: No
+			void CopyFrom(TreeNodeConsistencyCheckAddons const& rhs) {
+				if (rhs.board_view_) board_view_.reset(new board::BoardView(*rhs.board_view_));
+				else board_view_.reset();
+				action_type_ = rhs.action_type_;
+			}
+
 		private:
 			bool LockedCheckBoard(board::BoardView const& new_view) {
 				if (!board_view_) {
@@ -101,7 +109,7 @@ namespace mcts
 			TreeNodeLeadingNodes() : mutex_(), items_() {}
 
 			void AddLeadingNodes(TreeNode * node, int choice) {
-				std::lock_guard<Utils::SharedSpinLock> lock(mutex_);
+				std::lock_guard<detail::TreeNodeLeadingNodesLock> lock(mutex_);
 				assert(node);
 				assert(choice >= 0);
 				items_.insert(TreeNodeLeadingNodesItem{ node, choice });
@@ -109,14 +117,36 @@ namespace mcts
 
 			template <class Functor>
 			void ForEachLeadingNode(Functor&& op) {
-				std::shared_lock<Utils::SharedSpinLock> lock(mutex_);
+				std::shared_lock<detail::TreeNodeLeadingNodesLock> lock(mutex_);
 				for (auto const& item : items_) {
 					if (!op(item.node, item.choice)) break;
 				}
 			}
 
+			// predicate(TreeNode * node, int choice) -> remove or not
+			template <class Predicate>
+			void RemoveIf(Predicate&& predicate) {
+				std::lock_guard<detail::TreeNodeLeadingNodesLock> lock(mutex_);
+				for (auto it = items_.begin(); it != items_.end();) {
+					if (predicate(it->node, it->choice)) it = items_.erase(it);
+					else ++it;
+				}
+			}
+
+			// The nodes are mapped by 'node_mapper' (TreeNode const* -> TreeNode *);
+			// the ones mapped to nullptr are dropped
+			// Thread safety: No
+			template <class NodeMapper>
+			void CopyFrom(TreeNodeLeadingNodes const& rhs, NodeMapper && node_mapper) {
+				items_.clear();
+				for (auto const& item : rhs.items_) {
+					TreeNode * node = node_mapper(item.node);
+					if (node) items_.insert(TreeNodeLeadingNodesItem{ node, item.choice });
+				}
+			}
+
 		private:
-			mutable Utils::SharedSpinLock mutex_;
+			mutable detail::TreeNodeLeadingNodesLock mutex_;
 
 			// both node and choice are in the key field,
 			// since different choices might need to an identical node
@@ -137,6 +167,15 @@ namespace mcts
 				leading_nodes()
 			{}
 
+			// The nodes are mapped by 'node_mapper' (see TreeNode::CopyFrom)
+			template <class NodeMapper>
+			void CopyFrom(TreeNodeAddon const& rhs, NodeMapper && node_mapper) {
+				action_analyzer = rhs.action_analyzer;
+				consistency_checker.CopyFrom(rhs.consistency_checker);
+				board_node_map.CopyFrom(rhs.board_node_map, node_mapper);
+				leading_nodes.CopyFrom(rhs.leading_nodes, node_mapper);
+			}
+
 			board::BoardActionAnalyzer action_analyzer;
 			TreeNodeConsistencyCheckAddons consistency_checker; // TODO: debug only
 			detail::BoardNodeMap board_node_map;
@@ -54,12 +54,20 @@ public:
 public: // for training
 	void InitializeTrain();
 	void AddTrainData(IInputGetter * getter, int label, bool for_validate);
+	void AddTrainData(float const* input, int label, bool for_validate); // see NeuralNetworkInput
 	void Train();
 
 public: // for prediction
 	void InitializePredict(std::string const& filename);
 	double Predict(IInputGetter * getter);
 
+	// 'input': the encoded features, see NeuralNetworkInput
+	double Predict(float const* input);
+
+	// Evaluate 'count' inputs in one mini-batch
+	// Not thread-safe. See NeuralNetworkService to share a network among threads.
+	void Predict(float const* const* inputs, size_t count, double * results);
+
 private:
 	impl::NeuralNetworkWrapperImpl * impl_;
 };
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <assert.h>
+#include <cstring>
+#include <stdexcept>
+
+#include "NeuralNetwork.h"
+#include "NeuralNetworkKernel.h"
+
+// The input layout of the value network, shared by the training data (read
+// through NeuralNetworkWrapper::IInputGetter) and the game states (see
+// NeuralNetworkStateEncoder)
+//    [heroes]      hp + armor, of the current player and the opponent
+//    [minions]     7 fields per minion, 7 slots per side; empty slots are padded
+//    [standalone]  resources, hand, hero power of the current player
+// Every feature is normalized to mean 0 and variance 1, as if it is uniformly
+// distributed over its range.
+class NeuralNetworkInput
+{
+public:
+	static constexpr int kMaxMinions = NeuralNetworkKernel::kMinionCount;
+	static constexpr int kMinionFields = NeuralNetworkKernel::kMinionInDim;
+	static constexpr int kMaxHandCards = 10;
+
+	static constexpr int kHeroesOffset = 0;
+	static constexpr int kMinionsOffset = kHeroesOffset + NeuralNetworkKernel::kHeroInputSize;
+	static constexpr int kStandaloneOffset = kMinionsOffset + NeuralNetworkKernel::kMinionInputSize;
+	static constexpr int kSize = NeuralNetworkKernel::kInputSize;
+
+	// Offsets in the standalone features
+	static constexpr int kResourceCurrent = 0;
+	static constexpr int kResourceTotal = 1;
+	static constexpr int kResourceOverloadNext = 2;
+	static constexpr int kHandCount = 3;
+	static constexpr int kHandPlayableCount = 4;
+	static constexpr int kHandCosts = 5;
+	static constexpr int kOpponentHandCount = kHandCosts + kMaxHandCards;
+	static constexpr int kHeroPowerPlayable = kOpponentHandCount + 1;
+
+	static_assert(kHeroPowerPlayable + 1 == NeuralNetworkKernel::kStandaloneInDim, "standalone layout");
+	static_assert(kStandaloneOffset + NeuralNetworkKernel::kStandaloneInDim == kSize, "input layout");
+
+public:
+	// Empties the minion slots and the hand; the other features are to be set
+	// by the Set*() methods
+	static void Clear(float * input);
+
+	// From the fields read one by one, e.g., from the json boards of the
+	// training data
+	static void Encode(NeuralNetworkWrapper::IInputGetter * getter, float * input) {
+		Clear(input);
+
+		for (auto side : { NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kOpponent }) {
+			int hp = (int)getter->GetField(side, NeuralNetworkWrapper::kHeroHP) +
+				(int)getter->GetField(side, NeuralNetworkWrapper::kHeroArmor);
+			SetHero(input, side, hp);
+		}
+
+		for (auto side : { NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kOpponent }) {
+			int count = (int)getter->GetField(side, NeuralNetworkWrapper::kMinionCount);
+			if (count > kMaxMinions) throw std::runtime_error("too many minions");
+			for (int i = 0; i < count; ++i) {
+				SetMinion(input, side, i,
+					(int)getter->GetField(side, NeuralNetworkWrapper::kMinionHP, i),
+					(int)getter->GetField(side, NeuralNetworkWrapper::kMinionMaxHP, i),
+					(int)getter->GetField(side, NeuralNetworkWrapper::kMinionAttack, i),
+					getter->GetField(side, NeuralNetworkWrapper::kMinionAttackable, i) != 0.0,
+					getter->GetField(side, NeuralNetworkWrapper::kMinionTaunt, i) != 0.0,
+					getter->GetField(side, NeuralNetworkWrapper::kMinionShield, i) != 0.0,
+					getter->GetField(side, NeuralNetworkWrapper::kMinionStealth, i) != 0.0);
+			}
+		}
+
+		SetResource(input,
+			(int)getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceCurrent),
+			(int)getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceTotal),
+			(int)getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceOverloadNext));
+
+		int hand_count = (int)getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandCount);
+		if (hand_count > kMaxHandCards) throw std::runtime_error("too many hand cards");
+		int costs[kMaxHandCards];
+		int playable_count = 0;
+		for (int i = 0; i < hand_count; ++i) {
+			costs[i] = (int)getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandCost, i);
+			if (getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandPlayable, i) != 0.0) {
+				++playable_count;
+			}
+		}
+		SetHand(input, hand_count, playable_count, costs);
+
+		SetOpponentHand(input,
+			(int)getter->GetField(NeuralNetworkWrapper::kOpponent, NeuralNetworkWrapper::kHandCount));
+		SetHeroPower(input,
+			getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHeroPowerPlayable) != 0.0);
+	}
+
+	static void SetHero(float * input, NeuralNetworkWrapper::FieldSide side, int hp_and_armor) {
+		input[kHeroesOffset + SideIndex(side)] = NormalizeFromUniformDist(hp_and_armor, 0.0, 30.0);
+	}
+
+	static void SetMinion(
+		float * input, NeuralNetworkWrapper::FieldSide side, int minion_idx,
+		int hp, int max_hp, int attack, bool attackable, bool taunt, bool shield, bool stealth)
+	{
+		float * minion = GetMinion(input, side, minion_idx);
+		minion[0] = NormalizeFromUniformDist(hp, 1.0, 7.0);
+		minion[1] = NormalizeFromUniformDist(max_hp, 1.0, 7.0);
+		minion[2] = NormalizeFromUniformDist(attack, 0.0, 7.0);
+		minion[3] = NormalizeBool(attackable);
+		minion[4] = NormalizeBool(taunt);
+		minion[5] = NormalizeBool(shield);
+		minion[6] = NormalizeBool(stealth);
+	}
+
+	static void SetResource(float * input, int current, int total, int overload_next) {
+		float * standalone = input + kStandaloneOffset;
+		standalone[kResourceCurrent] = NormalizeFromUniformDist(current, 0.0, 10.0);
+		standalone[kResourceTotal] = NormalizeFromUniformDist(total, 0.0, 10.0);
+		standalone[kResourceOverloadNext] = NormalizeFromUniformDist(overload_next, 0.0, 10.0);
+	}
+
+	// 'costs': the cost of each card in hand
+	static void SetHand(float * input, int count, int playable_count, int const* costs) {
+		if (count > kMaxHandCards) throw std::runtime_error("too many hand cards");
+
+		float * standalone = input + kStandaloneOffset;
+		standalone[kHandCount] = NormalizeFromUniformDist(count, 0.0, 10.0);
+		standalone[kHandPlayableCount] = NormalizeFromUniformDist(playable_count, 0.0, 10.0);
+		for (int i = 0; i < count; ++i) {
+			standalone[kHandCosts + i] = NormalizeFromUniformDist(costs[i], 0.0, 10.0);
+		}
+	}
+
+	static void SetOpponentHand(float * input, int count) {
+		input[kStandaloneOffset + kOpponentHandCount] = NormalizeFromUniformDist(count, 0.0, 10.0);
+	}
+
+	static void SetHeroPower(float * input, bool playable) {
+		input[kStandaloneOffset + kHeroPowerPlayable] = NormalizeBool(playable);
+	}
+
+private:
+	struct Empty {
+		constexpr Empty() : input() {
+			for (auto side : { NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kOpponent }) {
+				for (int i = 0; i < kMaxMinions; ++i) {
+					float * minion = GetMinion(input, side, i);
+					minion[0] = 0.0f;
+					minion[1] = 0.0f;
+					minion[2] = 0.0f;
+					minion[3] = NormalizeBool(false);
+					minion[4] = NormalizeBool(false);
+					minion[5] = NormalizeBool(false);
+					minion[6] = NormalizeBool(false);
+				}
+			}
+			for (int i = 0; i < kMaxHandCards; ++i) {
+				input[kStandaloneOffset + kHandCosts + i] = NormalizeFromUniformDist(-1, 0.0, 10.0);
+			}
+		}
+		float input[kSize];
+	};
+
+	static constexpr int SideIndex(NeuralNetworkWrapper::FieldSide side) {
+		assert(side == NeuralNetworkWrapper::kCurrent || side == NeuralNetworkWrapper::kOpponent);
+		return side == NeuralNetworkWrapper::kCurrent ? 0 : 1;
+	}
+
+	static constexpr float * GetMinion(float * input, NeuralNetworkWrapper::FieldSide side, int minion_idx) {
+		assert(minion_idx >= 0 && minion_idx < kMaxMinions);
+		return input + kMinionsOffset + (SideIndex(side) * kMaxMinions + minion_idx) * kMinionFields;
+	}
+
+	static constexpr float NormalizeFromUniformDist(double v, double min, double max) {
+		// normalize to mean = 0, var = 1.0
+		// uniform dist is with variance = (max-min)^2 / 12
+		// --> so we should have (max-min)^2 / 12 = 1.0
+		// --> (max-min)^2 = 12.0
+		// --> (max-min) = sqrt(12.0)
+		constexpr double sqrt_12 = 3.46410161513775458705; // std::sqrt(12.0)
+
+		// The ranges are constants, so only a float multiply-add is left
+		double mean = (min + max) / 2;
+		double range = (max - min);
+		float scale = (float)(sqrt_12 / range);
+		float offset = (float)(-mean * sqrt_12 / range);
+
+		return (float)v * scale + offset;
+	}
+
+	static constexpr float NormalizeBool(bool v) {
+		double vv = 0.0;
+		if (v) vv = 1.0;
+		else vv = -1.0;
+		return NormalizeFromUniformDist(vv, -1.0, 1.0);
+	}
+};
+
+inline void NeuralNetworkInput::Clear(float * input)
+{
+	static constexpr Empty empty{};
+	std::memcpy(input, empty.input, sizeof(empty.input));
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define NEURAL_NETWORK_KERNEL_AVX2
+#endif
+
+// The forward pass of the value network built in NeuralNetworkWrapper::Train(),
+// with all the dimensions known at compile time
+//    heroes:     conv 1x1 over 2 heroes, 1 -> 1 channel, leaky-relu
+//    minions:    conv 7x1 over 14 slots, 1 -> 3 channels, leaky-relu
+//    concat:     2 + 42 + 17 standalone features = 61
+//    fc1:        61 -> 10, leaky-relu
+//    fc2:        10 -> 1
+// The weights are taken from tiny-dnn in its own layouts, see the Set*()
+// methods. The input is the one given to tiny-dnn: the three input layers, one
+// after another.
+// Thread safety: Forward() is const, and can be called from multiple threads
+class NeuralNetworkKernel
+{
+public:
+	static constexpr int kHeroInDim = 1;
+	static constexpr int kHeroOutDim = 1;
+	static constexpr int kHeroes = 2;
+	static constexpr int kMinionInDim = 7;
+	static constexpr int kMinionOutDim = 3;
+	static constexpr int kMinionCount = 7;
+	static constexpr int kMinionSlots = kMinionCount * 2;
+	static constexpr int kStandaloneInDim = 17;
+	static constexpr int kFc1OutDim = 10;
+
+	static constexpr int kHeroInputSize = kHeroes * kHeroInDim;
+	static constexpr int kMinionInputSize = kMinionSlots * kMinionInDim;
+	static constexpr int kInputSize = kHeroInputSize + kMinionInputSize + kStandaloneInDim;
+	static constexpr int kConcatSize = kHeroes * kHeroOutDim + kMinionSlots * kMinionOutDim + kStandaloneInDim;
+
+	// tiny-dnn's default slope
+	static constexpr float kLeakyReluEpsilon = 0.01f;
+
+private:
+	// Padded to a multiple of eight floats (a 256-bit register)
+	static constexpr int kLanes = 8;
+	static constexpr int kPaddedSlots = 16;
+	static constexpr int kPaddedFc1OutDim = 16;
+	static constexpr int kPaddedConcatSize = 64;
+
+public:
+	NeuralNetworkKernel() : weights_() {}
+
+	// 'w': one weight, 'b': one bias
+	void SetHeroConv(float const* w, float const* b) {
+		weights_.hero_w = w[0];
+		weights_.hero_b = b[0];
+	}
+
+	// 'w': [out_channel][window_x], 'b': [out_channel]
+	void SetMinionConv(float const* w, float const* b) {
+		for (int o = 0; o < kMinionOutDim; ++o) {
+			for (int x = 0; x < kMinionInDim; ++x) {
+				weights_.minion_w[o][x] = w[o * kMinionInDim + x];
+			}
+			weights_.minion_b[o] = b[o];
+		}
+	}
+
+	// 'w': [in][out], 'b': [out]
+	void SetFc1(float const* w, float const* b) {
+		std::memset(weights_.fc1_w, 0, sizeof(weights_.fc1_w));
+		std::memset(weights_.fc1_b, 0, sizeof(weights_.fc1_b));
+		for (int c = 0; c < kConcatSize; ++c) {
+			for (int i = 0; i < kFc1OutDim; ++i) {
+				weights_.fc1_w[c][i] = w[c * kFc1OutDim + i];
+			}
+		}
+		for (int i = 0; i < kFc1OutDim; ++i) weights_.fc1_b[i] = b[i];
+	}
+
+	// 'w': [in], 'b': one bias
+	void SetFc2(float const* w, float const* b) {
+		std::memset(weights_.fc2_w, 0, sizeof(weights_.fc2_w));
+		for (int i = 0; i < kFc1OutDim; ++i) weights_.fc2_w[i] = w[i];
+		weights_.fc2_b = b[0];
+	}
+
+	// 'input': kInputSize floats
+	float Forward(float const* input) const {
+#ifdef NEURAL_NETWORK_KERNEL_AVX2
+		return ForwardAVX2(input);
+#else
+		return ForwardScalar(input);
+#endif
+	}
+
+	// The layers as tiny-dnn computes them, one multiply-add at a time
+	float ForwardScalar(float const* input) const {
+		float concat[kConcatSize];
+		int idx = 0;
+
+		for (int y = 0; y < kHeroes; ++y) {
+			concat[idx++] = LeakyRelu(weights_.hero_w * input[y] + weights_.hero_b);
+		}
+
+		float const* minions = input + kHeroInputSize;
+		for (int o = 0; o < kMinionOutDim; ++o) {
+			for (int y = 0; y < kMinionSlots; ++y) {
+				float sum = 0.0f;
+				for (int x = 0; x < kMinionInDim; ++x) {
+					sum += weights_.minion_w[o][x] * minions[y * kMinionInDim + x];
+				}
+				concat[idx++] = LeakyRelu(sum + weights_.minion_b[o]);
+			}
+		}
+
+		float const* standalone = minions + kMinionInputSize;
+		for (int i = 0; i < kStandaloneInDim; ++i) concat[idx++] = standalone[i];
+		assert(idx == kConcatSize);
+
+		float result = 0.0f;
+		for (int i = 0; i < kFc1OutDim; ++i) {
+			float sum = 0.0f;
+			for (int c = 0; c < kConcatSize; ++c) {
+				sum += weights_.fc1_w[c][i] * concat[c];
+			}
+			result += weights_.fc2_w[i] * LeakyRelu(sum + weights_.fc1_b[i]);
+		}
+		return result + weights_.fc2_b;
+	}
+
+#ifdef NEURAL_NETWORK_KERNEL_AVX2
+	float ForwardAVX2(float const* input) const {
+		alignas(32) float concat[kPaddedConcatSize];
+		alignas(32) float minions_t[kMinionInDim][kPaddedSlots]; // [feature][slot]
+
+		concat[0] = LeakyRelu(weights_.hero_w * input[0] + weights_.hero_b);
+		concat[1] = LeakyRelu(weights_.hero_w * input[1] + weights_.hero_b);
+
+		// Transpose, so the slots go to the lanes
+		float const* minions = input + kHeroInputSize;
+		for (int y = 0; y < kMinionSlots; ++y) {
+			for (int x = 0; x < kMinionInDim; ++x) {
+				minions_t[x][y] = minions[y * kMinionInDim + x];
+			}
+		}
+		for (int x = 0; x < kMinionInDim; ++x) {
+			for (int y = kMinionSlots; y < kPaddedSlots; ++y) minions_t[x][y] = 0.0f;
+		}
+
+		__m256 const epsilon = _mm256_set1_ps(kLeakyReluEpsilon);
+		for (int o = 0; o < kMinionOutDim; ++o) {
+			__m256 lo = _mm256_set1_ps(weights_.minion_b[o]);
+			__m256 hi = lo;
+			for (int x = 0; x < kMinionInDim; ++x) {
+				__m256 w = _mm256_set1_ps(weights_.minion_w[o][x]);
+				lo = _mm256_fmadd_ps(w, _mm256_load_ps(&minions_t[x][0]), lo);
+				hi = _mm256_fmadd_ps(w, _mm256_load_ps(&minions_t[x][kLanes]), hi);
+			}
+			lo = _mm256_max_ps(lo, _mm256_mul_ps(lo, epsilon));
+			hi = _mm256_max_ps(hi, _mm256_mul_ps(hi, epsilon));
+
+			// Channel 'o' of the slots goes to [2 + o * 14, 2 + (o + 1) * 14)
+			float * out = concat + kHeroes + o * kMinionSlots;
+			_mm256_storeu_ps(out, lo);
+			alignas(32) float rest[kLanes];
+			_mm256_store_ps(rest, hi);
+			for (int y = kLanes; y < kMinionSlots; ++y) out[y] = rest[y - kLanes];
+		}
+
+		float const* standalone = minions + kMinionInputSize;
+		std::copy(standalone, standalone + kStandaloneInDim, concat + kHeroes + kMinionSlots * kMinionOutDim);
+
+		__m256 fc1_lo = _mm256_load_ps(&weights_.fc1_b[0]);
+		__m256 fc1_hi = _mm256_load_ps(&weights_.fc1_b[kLanes]);
+		for (int c = 0; c < kConcatSize; ++c) {
+			__m256 v = _mm256_set1_ps(concat[c]);
+			fc1_lo = _mm256_fmadd_ps(_mm256_load_ps(&weights_.fc1_w[c][0]), v, fc1_lo);
+			fc1_hi = _mm256_fmadd_ps(_mm256_load_ps(&weights_.fc1_w[c][kLanes]), v, fc1_hi);
+		}
+		fc1_lo = _mm256_max_ps(fc1_lo, _mm256_mul_ps(fc1_lo, epsilon));
+		fc1_hi = _mm256_max_ps(fc1_hi, _mm256_mul_ps(fc1_hi, epsilon));
+
+		// The padded outputs are zero, and so are their fc2 weights
+		__m256 sum = _mm256_fmadd_ps(fc1_hi, _mm256_load_ps(&weights_.fc2_w[kLanes]),
+			_mm256_mul_ps(fc1_lo, _mm256_load_ps(&weights_.fc2_w[0])));
+		__m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+		sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+		sum4 = _mm_add_ss(sum4, _mm_movehdup_ps(sum4));
+		return _mm_cvtss_f32(sum4) + weights_.fc2_b;
+	}
+#endif
+
+private:
+	static float LeakyRelu(float v) {
+		return v > 0.0f ? v : kLeakyReluEpsilon * v;
+	}
+
+private:
+	struct Weights {
+		float hero_w;
+		float hero_b;
+		float minion_w[kMinionOutDim][kMinionInDim];
+		float minion_b[kMinionOutDim];
+		float fc2_b;
+		alignas(32) float fc1_w[kConcatSize][kPaddedFc1OutDim]; // [in][out]
+		alignas(32) float fc1_b[kPaddedFc1OutDim];
+		alignas(32) float fc2_w[kPaddedFc1OutDim];
+	};
+	Weights weights_;
+};
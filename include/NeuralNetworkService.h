@@ -0,0 +1,181 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "NeuralNetwork.h"
+
+// Shares one network (and one copy of its weights) among the search threads,
+// and evaluates their requests in mini-batches
+// The first request of a batch leads it: it waits until the batch is full, or
+// until the wait limit passes, and then evaluates the whole batch on behalf of
+// the others. Meanwhile, the next batch is collected.
+// A batch is full at the maximum size, or when it holds a request from every
+// live requester (a thread which requested in the last kLiveWindow), so a
+// leader never waits for requests which cannot come.
+// A thread blocks only on its own request. The other threads keep on selecting,
+// and the virtual loss on the pending path steers them to other nodes.
+// Thread safety: Predict() can be called from any thread
+class NeuralNetworkService
+{
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Request {
+		float const* input;
+		double * result;
+	};
+
+	// Far longer than an iteration between two requests of a search thread
+	static constexpr std::chrono::milliseconds kLiveWindow{ 10 };
+
+public:
+	static constexpr size_t kDefaultMaxBatchSize = 32;
+	static constexpr std::chrono::microseconds kDefaultMaxWait{ 200 };
+
+	NeuralNetworkService() :
+		net_(), max_batch_size_(kDefaultMaxBatchSize), max_wait_(kDefaultMaxWait),
+		mutex_(), batch_full_cv_(), batch_taken_cv_(), batch_done_cv_(),
+		pending_(), batch_target_(0), last_requests_(), next_batch_id_(0), done_batch_id_(0), evaluating_(false),
+		batch_(), batch_inputs_(), batch_results_(), evaluations_(0), batches_(0)
+	{}
+
+	NeuralNetworkService(NeuralNetworkService const&) = delete;
+	NeuralNetworkService & operator=(NeuralNetworkService const&) = delete;
+
+	void Initialize(std::string const& filename) {
+		net_.InitializePredict(filename);
+	}
+
+	// The network of 'filename', loaded once in a process
+	static NeuralNetworkService & GetShared(std::string const& filename) {
+		static std::mutex mutex;
+		static std::map<std::string, std::unique_ptr<NeuralNetworkService>> services;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = services.find(filename);
+		if (it == services.end()) {
+			std::unique_ptr<NeuralNetworkService> service(new NeuralNetworkService());
+			service->Initialize(filename);
+			it = services.emplace(filename, std::move(service)).first;
+		}
+		return *it->second;
+	}
+
+	// A batch size of 1 evaluates every request right away
+	// Should be called before any request
+	void SetBatchLimits(size_t max_batch_size, std::chrono::microseconds max_wait) {
+		assert(max_batch_size > 0);
+		std::lock_guard<std::mutex> lock(mutex_);
+		max_batch_size_ = max_batch_size;
+		max_wait_ = max_wait;
+	}
+
+	// Blocks until the batch holding this request is evaluated
+	// 'input': the encoded features (see NeuralNetworkInput), valid until this returns
+	double Predict(float const* input) {
+		double result = 0.0;
+
+		std::unique_lock<std::mutex> lock(mutex_);
+
+		// A full batch is waiting to be taken by its leader
+		batch_taken_cv_.wait(lock, [this]() { return pending_.size() < max_batch_size_; });
+
+		auto now = Clock::now();
+		last_requests_[std::this_thread::get_id()] = now;
+
+		uint64_t batch_id = next_batch_id_;
+		bool leader = pending_.empty();
+		pending_.push_back({ input, &result });
+
+		if (!leader) {
+			if (pending_.size() >= batch_target_) batch_full_cv_.notify_one();
+			batch_done_cv_.wait(lock, [&]() { return done_batch_id_ > batch_id; });
+			return result;
+		}
+
+		batch_target_ = std::min(max_batch_size_, CountLiveRequesters(now));
+		batch_full_cv_.wait_for(lock, max_wait_, [this]() {
+			return pending_.size() >= batch_target_;
+		});
+
+		// The network is not thread-safe, one batch is evaluated at a time
+		// Other requests keep on joining this batch while we wait
+		batch_done_cv_.wait(lock, [this]() { return !evaluating_; });
+		evaluating_ = true;
+		++next_batch_id_; // later requests go to the next batch
+		batch_.assign(pending_.begin(), pending_.end());
+		pending_.clear();
+		lock.unlock();
+		batch_taken_cv_.notify_all();
+
+		size_t count = batch_.size();
+		batch_inputs_.clear();
+		for (auto const& request : batch_) batch_inputs_.push_back(request.input);
+		batch_results_.resize(count);
+		net_.Predict(batch_inputs_.data(), count, batch_results_.data());
+		for (size_t i = 0; i < count; ++i) {
+			*batch_[i].result = batch_results_[i];
+		}
+
+		lock.lock();
+		evaluations_ += count;
+		++batches_;
+		evaluating_ = false;
+		done_batch_id_ = batch_id + 1;
+		lock.unlock();
+		batch_done_cv_.notify_all();
+		return result;
+	}
+
+	// Average number of requests evaluated together
+	double GetAverageBatchSize() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (batches_ == 0) return 0.0;
+		return (double)evaluations_ / batches_;
+	}
+
+private:
+	// The threads requested in the last kLiveWindow, including the caller
+	// Should be called with 'mutex_' held
+	size_t CountLiveRequesters(Clock::time_point now) {
+		for (auto it = last_requests_.begin(); it != last_requests_.end();) {
+			if (now - it->second > kLiveWindow) it = last_requests_.erase(it);
+			else ++it;
+		}
+		return last_requests_.size();
+	}
+
+private:
+	NeuralNetworkWrapper net_;
+	size_t max_batch_size_;
+	std::chrono::microseconds max_wait_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable batch_full_cv_;
+	std::condition_variable batch_taken_cv_;
+	std::condition_variable batch_done_cv_;
+	std::vector<Request> pending_; // the batch being collected
+	size_t batch_target_; // the size the leader of 'pending_' waits for
+	std::unordered_map<std::thread::id, Clock::time_point> last_requests_;
+	uint64_t next_batch_id_;
+	uint64_t done_batch_id_; // batches before this one are evaluated
+	bool evaluating_;
+
+	// Only touched by the thread evaluating a batch
+	std::vector<Request> batch_;
+	std::vector<float const*> batch_inputs_;
+	std::vector<double> batch_results_;
+
+	uint64_t evaluations_;
+	uint64_t batches_;
+};
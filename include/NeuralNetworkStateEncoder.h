@@ -0,0 +1,74 @@
+#pragma once
+
+#include "state/State.h"
+#include "FlowControl/ValidActionGetter.h"
+#include "NeuralNetworkInput.h"
+
+// Fills the value network input from a game state, in one pass over the board
+// The features are seen from the current player, as FlowControl::JsonSerializer
+// writes them for the training data. Only the current player's minions can be
+// attackable.
+// Thread safety: Encode() only reads the state
+class NeuralNetworkStateEncoder
+{
+public:
+	// 'input': NeuralNetworkInput::kSize floats
+	static void Encode(state::State const& state, float * input) {
+		FlowControl::ValidActionGetter valid_action(state);
+		state::board::Player const& current = state.GetCurrentPlayer();
+		state::board::Player const& opponent = state.GetOppositePlayer();
+
+		NeuralNetworkInput::Clear(input);
+		EncodeHero(state, current, NeuralNetworkWrapper::kCurrent, input);
+		EncodeHero(state, opponent, NeuralNetworkWrapper::kOpponent, input);
+
+		EncodeMinions(state, current, NeuralNetworkWrapper::kCurrent, input, [&](state::Cards::Card const& card) {
+			return valid_action.IsAttackable(card);
+		});
+		EncodeMinions(state, opponent, NeuralNetworkWrapper::kOpponent, input, [](state::Cards::Card const&) {
+			return false;
+		});
+
+		auto const& resource = current.GetResource();
+		NeuralNetworkInput::SetResource(input, resource.GetCurrent(), resource.GetTotal(), resource.GetNextOverload());
+
+		int hand_count = (int)current.hand_.Size();
+		if (hand_count > NeuralNetworkInput::kMaxHandCards) throw std::runtime_error("too many hand cards");
+		int costs[NeuralNetworkInput::kMaxHandCards];
+		int playable_count = 0;
+		for (int i = 0; i < hand_count; ++i) {
+			costs[i] = state.GetCard(current.hand_.Get(i)).GetCost();
+			if (valid_action.IsPlayable(i)) ++playable_count;
+		}
+		NeuralNetworkInput::SetHand(input, hand_count, playable_count, costs);
+
+		NeuralNetworkInput::SetOpponentHand(input, (int)opponent.hand_.Size());
+		NeuralNetworkInput::SetHeroPower(input, valid_action.CanUseHeroPower());
+	}
+
+private:
+	static void EncodeHero(
+		state::State const& state, state::board::Player const& player,
+		NeuralNetworkWrapper::FieldSide side, float * input)
+	{
+		state::Cards::Card const& hero = state.GetCard(player.GetHeroRef());
+		NeuralNetworkInput::SetHero(input, side, hero.GetHP() + hero.GetArmor());
+	}
+
+	template <class AttackableGetter>
+	static void EncodeMinions(
+		state::State const& state, state::board::Player const& player,
+		NeuralNetworkWrapper::FieldSide side, float * input, AttackableGetter && attackable)
+	{
+		int idx = 0;
+		player.minions_.ForEach([&](state::CardRef card_ref) {
+			if (idx >= NeuralNetworkInput::kMaxMinions) throw std::runtime_error("too many minions");
+			state::Cards::Card const& minion = state.GetCard(card_ref);
+			NeuralNetworkInput::SetMinion(input, side, idx,
+				minion.GetHP(), minion.GetMaxHP(), minion.GetAttack(), attackable(minion),
+				minion.HasTaunt(), minion.HasShield(), minion.HasStealth());
+			++idx;
+			return true;
+		});
+	}
+};
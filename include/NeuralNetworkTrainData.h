@@ -0,0 +1,175 @@
+#pragma once
+
+#include <assert.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "NeuralNetworkInput.h"
+
+// The binary training data: a header, then fixed-size samples one after another
+// The samples are the encoded network inputs (see NeuralNetworkInput), so they
+// can be fed to the network as they are in the file.
+namespace NeuralNetworkTrainData
+{
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t input_size;
+	};
+
+	struct Sample {
+		float input[NeuralNetworkInput::kSize];
+		int32_t label; // 1 if the current player wins; -1 otherwise
+		int32_t turn;
+	};
+	static_assert(sizeof(Sample) == sizeof(float) * NeuralNetworkInput::kSize + 8, "no padding in samples");
+
+	constexpr char kMagic[8] = { 'H', 'S', 'T', 'R', 'A', 'I', 'N', '\0' };
+	constexpr uint32_t kVersion = 1;
+
+	inline Header GetHeader() {
+		Header header;
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = kVersion;
+		header.input_size = NeuralNetworkInput::kSize;
+		return header;
+	}
+
+	class Writer
+	{
+	public:
+		Writer(std::string const& filename) : fs_(filename, std::ios::binary | std::ios::trunc) {
+			if (!fs_) throw std::runtime_error("cannot open " + filename);
+			Header header = GetHeader();
+			fs_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		}
+
+		void Write(Sample const& sample) {
+			fs_.write(reinterpret_cast<char const*>(&sample), sizeof(sample));
+		}
+
+		void Close() {
+			fs_.close();
+			if (!fs_) throw std::runtime_error("failed to write training data");
+		}
+
+	private:
+		std::ofstream fs_;
+	};
+
+	// Maps a file to memory; the samples are read in place
+	// Thread safety: the samples can be read from multiple threads
+	class Reader
+	{
+	public:
+		Reader(std::string const& filename) : data_(nullptr), size_(0), samples_(nullptr), count_(0)
+#ifdef _MSC_VER
+			, buffer_()
+#else
+			, fd_(-1)
+#endif
+		{
+			Map(filename);
+			try {
+				Validate(filename);
+			}
+			catch (...) {
+				Unmap();
+				throw;
+			}
+		}
+
+		Reader(Reader const&) = delete;
+		Reader & operator=(Reader const&) = delete;
+
+		~Reader() { Unmap(); }
+
+		size_t Size() const { return count_; }
+		Sample const& Get(size_t idx) const {
+			assert(idx < count_);
+			return samples_[idx];
+		}
+
+	private:
+		void Validate(std::string const& filename) {
+			Header header;
+			if (size_ < sizeof(header)) throw std::runtime_error("invalid training data: " + filename);
+			std::memcpy(&header, data_, sizeof(header));
+			if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+				header.version != kVersion ||
+				header.input_size != NeuralNetworkInput::kSize)
+			{
+				throw std::runtime_error("invalid training data: " + filename);
+			}
+			if ((size_ - sizeof(header)) % sizeof(Sample) != 0) {
+				throw std::runtime_error("truncated training data: " + filename);
+			}
+
+			samples_ = reinterpret_cast<Sample const*>(data_ + sizeof(header));
+			count_ = (size_ - sizeof(header)) / sizeof(Sample);
+		}
+
+#ifdef _MSC_VER
+		void Map(std::string const& filename) {
+			std::ifstream fs(filename, std::ios::binary);
+			if (!fs) throw std::runtime_error("cannot open " + filename);
+			buffer_.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+			data_ = buffer_.data();
+			size_ = buffer_.size();
+		}
+
+		void Unmap() {}
+#else
+		void Map(std::string const& filename) {
+			fd_ = open(filename.c_str(), O_RDONLY);
+			if (fd_ < 0) throw std::runtime_error("cannot open " + filename);
+
+			struct stat st;
+			if (fstat(fd_, &st) != 0 || st.st_size == 0) {
+				Unmap();
+				throw std::runtime_error("invalid training data: " + filename);
+			}
+			size_ = (size_t)st.st_size;
+
+			void * p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+			if (p == MAP_FAILED) {
+				Unmap();
+				throw std::runtime_error("cannot map " + filename);
+			}
+			data_ = static_cast<char const*>(p);
+			madvise(p, size_, MADV_SEQUENTIAL);
+		}
+
+		void Unmap() {
+			if (data_) munmap(const_cast<char *>(data_), size_);
+			if (fd_ >= 0) close(fd_);
+			data_ = nullptr;
+			fd_ = -1;
+		}
+#endif
+
+	private:
+		char const* data_;
+		size_t size_;
+		Sample const* samples_;
+		size_t count_;
+#ifdef _MSC_VER
+		std::vector<char> buffer_;
+#else
+		int fd_;
+#endif
+	};
+}
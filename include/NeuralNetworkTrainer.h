@@ -0,0 +1,339 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "NeuralNetworkKernel.h"
+
+// Trains the value network of NeuralNetworkKernel on multiple threads
+// Every mini-batch is cut into chunks of kChunkSize samples. The chunks are
+// spread over the threads, each chunk sums the gradients of its samples, and
+// the chunks are summed in order. So the result does not depend on the number
+// of threads.
+// The parameters are kept in tiny-dnn's layouts (see NeuralNetworkKernel), so
+// they can be copied from and to tiny-dnn as they are. The loss is tiny-dnn's
+// mse, and the optimizer is adam with tiny-dnn's default hyper-parameters.
+class NeuralNetworkTrainer
+{
+public:
+	static constexpr size_t kBatchSize = 256;
+	static constexpr size_t kChunkSize = 8;
+	static constexpr size_t kChunksPerBatch = kBatchSize / kChunkSize;
+	static_assert(kBatchSize % kChunkSize == 0, "whole chunks in a batch");
+
+	enum Layer {
+		kHeroConv,
+		kMinionConv,
+		kFc1,
+		kFc2,
+		kLayers
+	};
+
+	class DataSet
+	{
+	public:
+		void Add(float const* input, float label) {
+			inputs_.insert(inputs_.end(), input, input + NeuralNetworkKernel::kInputSize);
+			labels_.push_back(label);
+		}
+
+		size_t Size() const { return labels_.size(); }
+		float const* GetInput(size_t idx) const { return &inputs_[idx * NeuralNetworkKernel::kInputSize]; }
+		float GetLabel(size_t idx) const { return labels_[idx]; }
+
+	private:
+		std::vector<float> inputs_;
+		std::vector<float> labels_;
+	};
+
+private:
+	static constexpr int kHeroW = 0;
+	static constexpr int kHeroB = kHeroW + NeuralNetworkKernel::kHeroInDim * NeuralNetworkKernel::kHeroOutDim;
+	static constexpr int kMinionW = kHeroB + NeuralNetworkKernel::kHeroOutDim;
+	static constexpr int kMinionB = kMinionW + NeuralNetworkKernel::kMinionInDim * NeuralNetworkKernel::kMinionOutDim;
+	static constexpr int kFc1W = kMinionB + NeuralNetworkKernel::kMinionOutDim;
+	static constexpr int kFc1B = kFc1W + NeuralNetworkKernel::kConcatSize * NeuralNetworkKernel::kFc1OutDim;
+	static constexpr int kFc2W = kFc1B + NeuralNetworkKernel::kFc1OutDim;
+	static constexpr int kFc2B = kFc2W + NeuralNetworkKernel::kFc1OutDim;
+	static constexpr int kParameters = kFc2B + 1;
+
+	static_assert(NeuralNetworkKernel::kHeroInDim == 1 && NeuralNetworkKernel::kHeroOutDim == 1,
+		"the hero conv is a scalar multiply-add");
+
+	// Aligned to a cache line, so the threads do not share one
+	struct alignas(64) Gradients {
+		float values[kParameters];
+		double loss;
+	};
+
+	// Threads wait here for each other
+	class SpinBarrier
+	{
+	public:
+		SpinBarrier(int threads) : threads_(threads), waiting_(0), generation_(0) {}
+
+		void Wait() {
+			int generation = generation_.load(std::memory_order_acquire);
+			if (waiting_.fetch_add(1, std::memory_order_acq_rel) + 1 == threads_) {
+				waiting_.store(0, std::memory_order_relaxed);
+				generation_.fetch_add(1, std::memory_order_acq_rel);
+				return;
+			}
+			while (generation_.load(std::memory_order_acquire) == generation) {
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		int const threads_;
+		std::atomic<int> waiting_;
+		std::atomic<int> generation_;
+	};
+
+public:
+	NeuralNetworkTrainer(int threads) :
+		threads_(std::max(threads, 1)), params_(), adam_m_(), adam_v_(), step_(0),
+		gradients_(kChunksPerBatch)
+	{}
+
+	static size_t GetWeightsSize(Layer layer) { return GetBiasOffset(layer) - GetWeightsOffset(layer); }
+	static size_t GetBiasSize(Layer layer) { return GetWeightsOffset((Layer)(layer + 1)) - GetBiasOffset(layer); }
+	float * GetWeights(Layer layer) { return params_ + GetWeightsOffset(layer); }
+	float * GetBias(Layer layer) { return params_ + GetBiasOffset(layer); }
+
+	void SetKernel(NeuralNetworkKernel & kernel) const {
+		kernel.SetHeroConv(params_ + kHeroW, params_ + kHeroB);
+		kernel.SetMinionConv(params_ + kMinionW, params_ + kMinionB);
+		kernel.SetFc1(params_ + kFc1W, params_ + kFc1B);
+		kernel.SetFc2(params_ + kFc2W, params_ + kFc2B);
+	}
+
+	// One pass over the data in order; returns the mean loss
+	double TrainEpoch(DataSet const& data) {
+		double loss = 0.0;
+		SpinBarrier barrier(threads_);
+		RunThreads(threads_, [&](int thread_idx) {
+			for (size_t begin = 0; begin < data.Size(); begin += kBatchSize) {
+				size_t batch_size = std::min(kBatchSize, data.Size() - begin);
+				size_t chunks = (batch_size + kChunkSize - 1) / kChunkSize;
+
+				for (size_t chunk = thread_idx; chunk < chunks; chunk += threads_) {
+					size_t chunk_begin = begin + chunk * kChunkSize;
+					size_t chunk_end = std::min(chunk_begin + kChunkSize, begin + batch_size);
+					ComputeGradients(data, chunk_begin, chunk_end, gradients_[chunk]);
+				}
+				barrier.Wait();
+
+				if (thread_idx == 0) {
+					for (size_t chunk = 0; chunk < chunks; ++chunk) loss += gradients_[chunk].loss;
+					Update(chunks, batch_size);
+				}
+				barrier.Wait();
+			}
+		});
+		return data.Size() > 0 ? loss / data.Size() : 0.0;
+	}
+
+	// The number of samples whose sign of prediction matches the label
+	static size_t CountCorrect(DataSet const& data, NeuralNetworkKernel const& kernel, int threads) {
+		threads = std::max(threads, 1);
+		std::vector<size_t> corrects(threads, 0);
+		RunThreads(threads, [&](int thread_idx) {
+			size_t begin = data.Size() * thread_idx / threads;
+			size_t end = data.Size() * (thread_idx + 1) / threads;
+			size_t correct = 0;
+			for (size_t idx = begin; idx < end; ++idx) {
+				bool predict_win = kernel.Forward(data.GetInput(idx)) > 0.0f;
+				bool actual_win = data.GetLabel(idx) > 0.0f;
+				if (predict_win == actual_win) ++correct;
+			}
+			corrects[thread_idx] = correct;
+		});
+
+		size_t correct = 0;
+		for (size_t v : corrects) correct += v;
+		return correct;
+	}
+
+	// The prediction of the parameters being trained
+	float Forward(float const* input) const {
+		Activations activations;
+		return Forward(input, activations);
+	}
+
+private:
+	static int GetWeightsOffset(Layer layer) {
+		switch (layer) {
+		case kHeroConv: return kHeroW;
+		case kMinionConv: return kMinionW;
+		case kFc1: return kFc1W;
+		case kFc2: return kFc2W;
+		default: return kParameters;
+		}
+	}
+
+	static int GetBiasOffset(Layer layer) {
+		switch (layer) {
+		case kHeroConv: return kHeroB;
+		case kMinionConv: return kMinionB;
+		case kFc1: return kFc1B;
+		case kFc2: return kFc2B;
+		default: assert(false); return kParameters;
+		}
+	}
+
+	template <class Functor>
+	static void RunThreads(int threads, Functor && functor) {
+		std::vector<std::thread> workers;
+		for (int i = 1; i < threads; ++i) {
+			workers.emplace_back([&functor, i]() { functor(i); });
+		}
+		functor(0);
+		for (auto & worker : workers) worker.join();
+	}
+
+	// The values before the activations are kept for the backward pass
+	struct Activations {
+		float hero_z[NeuralNetworkKernel::kHeroes];
+		float minion_z[NeuralNetworkKernel::kMinionOutDim][NeuralNetworkKernel::kMinionSlots];
+		float concat[NeuralNetworkKernel::kConcatSize];
+		float fc1_z[NeuralNetworkKernel::kFc1OutDim];
+	};
+
+	float Forward(float const* input, Activations & a) const {
+		int idx = 0;
+		for (int y = 0; y < NeuralNetworkKernel::kHeroes; ++y) {
+			a.hero_z[y] = params_[kHeroW] * input[y] + params_[kHeroB];
+			a.concat[idx++] = LeakyRelu(a.hero_z[y]);
+		}
+
+		float const* minions = input + NeuralNetworkKernel::kHeroInputSize;
+		for (int o = 0; o < NeuralNetworkKernel::kMinionOutDim; ++o) {
+			float const* w = params_ + kMinionW + o * NeuralNetworkKernel::kMinionInDim;
+			for (int y = 0; y < NeuralNetworkKernel::kMinionSlots; ++y) {
+				float sum = 0.0f;
+				for (int x = 0; x < NeuralNetworkKernel::kMinionInDim; ++x) {
+					sum += w[x] * minions[y * NeuralNetworkKernel::kMinionInDim + x];
+				}
+				a.minion_z[o][y] = sum + params_[kMinionB + o];
+				a.concat[idx++] = LeakyRelu(a.minion_z[o][y]);
+			}
+		}
+
+		float const* standalone = minions + NeuralNetworkKernel::kMinionInputSize;
+		for (int i = 0; i < NeuralNetworkKernel::kStandaloneInDim; ++i) a.concat[idx++] = standalone[i];
+		assert(idx == NeuralNetworkKernel::kConcatSize);
+
+		for (int i = 0; i < NeuralNetworkKernel::kFc1OutDim; ++i) a.fc1_z[i] = params_[kFc1B + i];
+		for (int c = 0; c < NeuralNetworkKernel::kConcatSize; ++c) {
+			float const* w = params_ + kFc1W + c * NeuralNetworkKernel::kFc1OutDim;
+			for (int i = 0; i < NeuralNetworkKernel::kFc1OutDim; ++i) a.fc1_z[i] += w[i] * a.concat[c];
+		}
+
+		float result = params_[kFc2B];
+		for (int i = 0; i < NeuralNetworkKernel::kFc1OutDim; ++i) {
+			result += params_[kFc2W + i] * LeakyRelu(a.fc1_z[i]);
+		}
+		return result;
+	}
+
+	// Sums the gradients of the samples [begin, end)
+	void ComputeGradients(DataSet const& data, size_t begin, size_t end, Gradients & gradients) const {
+		float * g = gradients.values;
+		std::fill(g, g + kParameters, 0.0f);
+		gradients.loss = 0.0;
+
+		Activations a;
+		float d_concat[NeuralNetworkKernel::kConcatSize];
+		float d_fc1[NeuralNetworkKernel::kFc1OutDim];
+
+		for (size_t idx = begin; idx < end; ++idx) {
+			float const* input = data.GetInput(idx);
+			float diff = Forward(input, a) - data.GetLabel(idx);
+			gradients.loss += (double)diff * diff;
+
+			// mse: d(diff^2)/d(result)
+			float d_result = 2.0f * diff;
+
+			g[kFc2B] += d_result;
+			for (int i = 0; i < NeuralNetworkKernel::kFc1OutDim; ++i) {
+				g[kFc2W + i] += d_result * LeakyRelu(a.fc1_z[i]);
+				d_fc1[i] = d_result * params_[kFc2W + i] * LeakyReluDerivative(a.fc1_z[i]);
+				g[kFc1B + i] += d_fc1[i];
+			}
+
+			for (int c = 0; c < NeuralNetworkKernel::kConcatSize; ++c) {
+				float const* w = params_ + kFc1W + c * NeuralNetworkKernel::kFc1OutDim;
+				float * gw = g + kFc1W + c * NeuralNetworkKernel::kFc1OutDim;
+				float sum = 0.0f;
+				for (int i = 0; i < NeuralNetworkKernel::kFc1OutDim; ++i) {
+					gw[i] += d_fc1[i] * a.concat[c];
+					sum += w[i] * d_fc1[i];
+				}
+				d_concat[c] = sum;
+			}
+
+			int concat_idx = 0;
+			for (int y = 0; y < NeuralNetworkKernel::kHeroes; ++y) {
+				float d_z = d_concat[concat_idx++] * LeakyReluDerivative(a.hero_z[y]);
+				g[kHeroW] += d_z * input[y];
+				g[kHeroB] += d_z;
+			}
+
+			float const* minions = input + NeuralNetworkKernel::kHeroInputSize;
+			for (int o = 0; o < NeuralNetworkKernel::kMinionOutDim; ++o) {
+				float * gw = g + kMinionW + o * NeuralNetworkKernel::kMinionInDim;
+				for (int y = 0; y < NeuralNetworkKernel::kMinionSlots; ++y) {
+					float d_z = d_concat[concat_idx++] * LeakyReluDerivative(a.minion_z[o][y]);
+					for (int x = 0; x < NeuralNetworkKernel::kMinionInDim; ++x) {
+						gw[x] += d_z * minions[y * NeuralNetworkKernel::kMinionInDim + x];
+					}
+					g[kMinionB + o] += d_z;
+				}
+			}
+		}
+	}
+
+	// adam, on the mean gradients of the batch
+	void Update(size_t chunks, size_t batch_size) {
+		static constexpr float alpha = 0.001f;
+		static constexpr float b1 = 0.9f;
+		static constexpr float b2 = 0.999f;
+		static constexpr float eps = 1e-8f;
+
+		++step_;
+		float b1_t = 1.0f - (float)std::pow(b1, step_);
+		float b2_t = 1.0f - (float)std::pow(b2, step_);
+		float scale = 1.0f / batch_size;
+
+		for (int i = 0; i < kParameters; ++i) {
+			float dw = 0.0f;
+			for (size_t chunk = 0; chunk < chunks; ++chunk) dw += gradients_[chunk].values[i];
+			dw *= scale;
+
+			adam_m_[i] = b1 * adam_m_[i] + (1.0f - b1) * dw;
+			adam_v_[i] = b2 * adam_v_[i] + (1.0f - b2) * dw * dw;
+			params_[i] -= alpha * (adam_m_[i] / b1_t) / std::sqrt(adam_v_[i] / b2_t + eps);
+		}
+	}
+
+	static float LeakyRelu(float v) {
+		return v > 0.0f ? v : NeuralNetworkKernel::kLeakyReluEpsilon * v;
+	}
+
+	static float LeakyReluDerivative(float v) {
+		return v > 0.0f ? 1.0f : NeuralNetworkKernel::kLeakyReluEpsilon;
+	}
+
+private:
+	int const threads_;
+	float params_[kParameters];
+	float adam_m_[kParameters];
+	float adam_v_[kParameters];
+	int step_;
+	std::vector<Gradients> gradients_;
+};
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <thread>
 
 #include "state/State.h"
 #include "MCTS/MOMCTS.h"
+#include "MCTS/detail/RootPromoter.h"
 #include "UI/CompetitionGuide.h"
+#include "UI/SearchPool.h"
+#include "UI/TimeManager.h"
+#include "Utils/Arena.h"
 
 namespace ui
 {
@@ -14,57 +20,76 @@ namespace ui
 	{
 	private:
 		using StartingStateGetter = std::function<state::State(int)>;
+		using RootSampleGetter = std::function<state::State const&(int)>;
+		using TreeNode = mcts::builder::TreeBuilder::TreeNode;
 
 	public:
-		AIController(int tree_samples, std::mt19937 & rand) :
-			threads_(),
-			first_tree_(), second_tree_(), statistic_(), stop_flag_(false), tree_sample_randoms_()
+		// The searches run on the workers of 'pool'
+		AIController(int tree_samples, std::mt19937 & rand, SearchPool & pool = SearchPool::GetShared()) :
+			pool_(pool), search_(), arenas_(), tree_arena_(std::make_unique<Utils::Arena>()),
+			first_root_(CreateRoot()), second_root_(CreateRoot()),
+			statistic_(), budget_(), stop_flag_(false), tree_sample_randoms_()
 		{
 			for (int i = 0; i < tree_samples; ++i) {
 				tree_sample_randoms_.push_back(rand());
 			}
 		}
 
+		AIController(AIController const&) = delete;
+		AIController & operator=(AIController const&) = delete;
+
 		~AIController()
 		{
 			WaitUntilStopped();
+			tree_arena_->RunFinalizers();
+			ReleaseArenas();
+		}
+
+		// Stop growing the trees at 'max_nodes' nodes, or 'max_bytes' bytes
+		// (see mcts::TreeBudget)
+		void SetTreeBudget(size_t max_nodes, size_t max_bytes) {
+			budget_.SetLimits(max_nodes, max_bytes);
 		}
 
 		void Run(int thread_count, int seed, StartingStateGetter state_getter)
 		{
-			assert(threads_.empty());
-			stop_flag_ = false;
-			for (int i = 0; i < thread_count; ++i) {
-				threads_.emplace_back([this, seed, state_getter]() {
-					std::mt19937 selection_rand;
-					std::mt19937 simulation_rand(seed);
-					mcts::MOMCTS mcts(first_tree_, second_tree_, statistic_, selection_rand, simulation_rand);
-
-					size_t tree_sample_random_idx = 0;
-					auto get_next_selection_seed = [tree_sample_random_idx, this]() mutable {
-						int v = tree_sample_randoms_[tree_sample_random_idx];
-						++tree_sample_random_idx;
-						if (tree_sample_random_idx >= tree_sample_randoms_.size()) {
-							tree_sample_random_idx = 0;
-						}
-						return v;
-					};
-
-					while (true) {
-						if (stop_flag_ == true) break; // TODO: use compare_exchange_weak
-
-						int sample_seed = get_next_selection_seed();
-						selection_rand.seed(sample_seed);
-						mcts.Iterate([&]() {
-							return state_getter(sample_seed);
-						});
-
-						statistic_.IterateSucceeded();
-					}
+			RunThreads(thread_count, seed, [state_getter](mcts::MOMCTS & mcts, int sample_seed) {
+				mcts.Iterate([&]() {
+					return state_getter(sample_seed);
 				});
-			}
+			});
+		}
+
+		// Every iteration starts from 'root'
+		// Each thread forks the state of its iteration from the root (copy-on-write),
+		// and the containers in the state are reused instead of allocated again.
+		void Run(int thread_count, int seed, state::State const& root)
+		{
+			auto mutable_root = std::make_shared<state::State>(root);
+			mutable_root->GetViewHash(state::kPlayerFirst); // hash the changed cards once, see BoardGetter
+			std::shared_ptr<const state::State> shared_root = mutable_root;
+			RunThreads(thread_count, seed, [shared_root, state = state::State()](mcts::MOMCTS & mcts, int) mutable {
+				state.FillWithBase(*shared_root);
+				mcts.Iterate(state);
+			});
+		}
+
+		// Every iteration starts from one of the root samples prepared for the
+		// seeds of GetTreeSampleSeeds() (e.g., see BoardGetter)
+		// The samples are forked (copy-on-write) like 'root' above, instead of
+		// being built again for each iteration. They should be kept unchanged
+		// until the threads are stopped.
+		void RunOnRootSamples(int thread_count, int seed, RootSampleGetter sample_getter)
+		{
+			RunThreads(thread_count, seed, [sample_getter, state = state::State()](mcts::MOMCTS & mcts, int sample_seed) mutable {
+				state.FillWithBase(sample_getter(sample_seed));
+				mcts.Iterate(state);
+			});
 		}
 
+		// The seeds given to the state getters; each one stands for a root sample
+		std::vector<int> const& GetTreeSampleSeeds() const { return tree_sample_randoms_; }
+
 		int NotifyStop() {
 			stop_flag_ = true;
 			return 0;
@@ -77,92 +102,325 @@ namespace ui
 		void WaitUntilStopped()
 		{
 			NotifyStop();
-			for (auto & thread : threads_) {
-				thread.join();
+			if (search_) {
+				pool_.Remove(*search_);
+				search_.reset();
 			}
-			threads_.clear();
 		}
 
 		auto const& GetStatistic() const { return statistic_; }
+		auto const& GetTreeBudget() const { return budget_; }
+
+		// Memory held by the trees (in bytes)
+		// Can be called while the threads are running
+		size_t GetTreeMemoryUsage() const {
+			size_t bytes = 0;
+			for (auto const& arena : arenas_) {
+				bytes += arena->GetReservedBytes();
+			}
+			return bytes + tree_arena_->GetReservedBytes();
+		}
+
+		// Bytes allocated for the tree nodes and their addons
+		// Since UpdateRoot, only the nodes reachable from the roots are counted
+		// (besides the few left unused by the threads racing on a table).
+		// Can be called while the threads are running
+		size_t GetTreeAllocatedBytes() const {
+			size_t bytes = 0;
+			for (auto const& arena : arenas_) {
+				bytes += arena->GetAllocatedBytes();
+			}
+			return bytes + tree_arena_->GetAllocatedBytes();
+		}
+
+		TreeNode const* GetRootNode(state::PlayerIdentifier side) const {
+			if (side == state::kPlayerFirst) return first_root_;
+			assert(side == state::kPlayerSecond);
+			return second_root_;
+		}
+
+		// The iterations passed through the root of 'side' (e.g., the ones done
+		// ahead on a promoted root)
+		// Can be called while the threads are running
+		int64_t GetRootVisits(state::PlayerIdentifier side) const {
+			int64_t visits = 0;
+			GetRootNode(side)->ForEachChild([&](int, mcts::selection::ChildType const& child) {
+				visits += child.GetEdgeAddon().GetChosenTimes();
+				return true;
+			});
+			return visits;
+		}
+
+		// Step the roots to the node of 'state', so the next run continues on the
+		// existing trees, instead of starting over.
+		// The tree of the current player should hold the node, either after one of
+		// its main actions in the turn, or at the start of its next turn. If not,
+		// both trees are restarted, and false is returned.
+		// When a new turn starts, the tree of the other player is restarted, since
+		// the hidden cards in its boards are sampled.
+		// The nodes kept are copied to a new arena, and the old arenas are
+		// released, with the nodes no longer reachable.
+		// Should be called when the threads are stopped
+		bool UpdateRoot(state::State const& state) {
+			assert(!search_);
+
+			state::State current_state(state);
+			state::PlayerIdentifier side = current_state.GetCurrentPlayerId();
+			mcts::board::Board board(current_state, side.GetSide());
+
+			auto result = mcts::detail::RootPromoter::Promote(GetMutableRoot(side), board);
+
+			auto old_tree_arena = std::move(tree_arena_);
+			tree_arena_ = std::make_unique<Utils::Arena>();
+			if (result.node) {
+				{
+					Utils::Arena::ThreadScope arena_scope(*tree_arena_);
+					GetMutableRoot(side) = mcts::detail::RootPromoter::CopyTree(result.node);
+					if (result.depth > 1) {
+						GetMutableRoot(side.Opposite()) = CreateRoot();
+					}
+					else {
+						GetMutableRoot(side.Opposite()) =
+							mcts::detail::RootPromoter::CopyTree(GetMutableRoot(side.Opposite()));
+					}
+				}
+			}
+			else {
+				first_root_ = CreateRoot();
+				second_root_ = CreateRoot();
+			}
+
+			// The thread arenas are created again by the next run
+			arenas_.push_back(std::move(old_tree_arena));
+			ReleaseArenas();
+
+			// Only the nodes kept are counted, so the budget is not held up by the
+			// trees left behind
+			budget_.SetNodes(
+				mcts::detail::RootPromoter::CountNodes(first_root_) +
+				mcts::detail::RootPromoter::CountNodes(second_root_));
+			budget_.SetBytes(GetTreeAllocatedBytes());
+			return result.node != nullptr;
+		}
+
+	private:
+		// A search on the trees of this controller
+		// Each worker runs a copy of 'iterate': void(mcts::MOMCTS & mcts, int sample_seed)
+		template <class IterateFunctor>
+		class Search : public SearchPool::Search
+		{
+		public:
+			Search(AIController & controller, int seed, IterateFunctor const& iterate) :
+				controller_(controller), seed_(seed), iterate_(iterate)
+			{}
+
+			void Run(SearchPool::Scratch & scratch, int slot, std::function<bool()> const& should_leave) final {
+				auto & c = controller_;
+
+				// Each worker allocates tree nodes from the arena of its slot
+				Utils::Arena::ThreadScope arena_scope(*c.arenas_[slot]);
+
+				if (!scratch.mcts) {
+					scratch.mcts.reset(new mcts::MOMCTS(*c.first_root_, *c.second_root_, c.statistic_, c.budget_,
+						scratch.selection_rand, scratch.simulation_rand));
+				}
+				else {
+					scratch.mcts->Rebind(*c.first_root_, *c.second_root_, c.statistic_, c.budget_);
+				}
+				scratch.simulation_rand.seed(seed_);
+
+				IterateFunctor iterate(iterate_);
+
+				size_t tree_sample_random_idx = 0;
+				auto get_next_selection_seed = [&]() {
+					int v = c.tree_sample_randoms_[tree_sample_random_idx];
+					++tree_sample_random_idx;
+					if (tree_sample_random_idx >= c.tree_sample_randoms_.size()) {
+						tree_sample_random_idx = 0;
+					}
+					return v;
+				};
+
+				while (true) {
+					if (c.stop_flag_ == true) break; // TODO: use compare_exchange_weak
+					if (should_leave()) break;
+
+					int sample_seed = get_next_selection_seed();
+					scratch.selection_rand.seed(sample_seed);
+					iterate(*scratch.mcts, sample_seed);
+
+					c.statistic_.IterateSucceeded();
+					c.budget_.SetBytes(c.GetTreeAllocatedBytes());
+				}
+			}
+
+			bool IsStopping() const final { return controller_.IsStopping(); }
+
+		private:
+			AIController & controller_;
+			int seed_;
+			IterateFunctor iterate_;
+		};
+
+		template <class IterateFunctor>
+		void RunThreads(int thread_count, int seed, IterateFunctor iterate)
+		{
+			assert(!search_);
+			stop_flag_ = false;
+
+			// The idle workers might join in, each with an arena of its own
+			// Arenas are kept across runs, since the trees still refer to them,
+			// until the trees are copied out (see UpdateRoot)
+			int max_threads = std::max(thread_count, (int)pool_.GetWorkerCount());
+			while (arenas_.size() < (size_t)max_threads) {
+				arenas_.push_back(std::make_unique<Utils::Arena>());
+			}
+
+			search_.reset(new Search<IterateFunctor>(*this, seed, iterate));
+			pool_.Submit(*search_, thread_count, max_threads);
+		}
+
+		// The roots are not allocated from the thread arenas, since those are
+		// created when the threads run
+		TreeNode * CreateRoot() {
+			Utils::Arena::ThreadScope arena_scope(*tree_arena_);
+			return TreeNode::Create();
+		}
 
-		auto GetRootNode(state::PlayerIdentifier side) const {
-			if (side == state::kPlayerFirst) return &first_tree_;
+		// Releases the thread arenas; the nodes in them should be unreachable
+		// or copied out
+		void ReleaseArenas() {
+			// A container in one arena might hold elements allocated from another
+			for (auto & arena : arenas_) {
+				arena->RunFinalizers();
+			}
+			arenas_.clear();
+		}
+
+		TreeNode * & GetMutableRoot(state::PlayerIdentifier side) {
+			if (side == state::kPlayerFirst) return first_root_;
 			assert(side == state::kPlayerSecond);
-			return &second_tree_;
+			return second_root_;
 		}
 
 	private:
-		std::vector<std::thread> threads_;
-		mcts::builder::TreeBuilder::TreeNode first_tree_;
-		mcts::builder::TreeBuilder::TreeNode second_tree_;
+		SearchPool & pool_;
+		std::unique_ptr<SearchPool::Search> search_;
+		std::vector<std::unique_ptr<Utils::Arena>> arenas_; // should outlive the trees
+		std::unique_ptr<Utils::Arena> tree_arena_; // the roots, and the trees copied by UpdateRoot
+		TreeNode * first_root_;
+		TreeNode * second_root_;
 		mcts::Statistic<> statistic_;
+		mcts::TreeBudget budget_;
 		std::atomic_bool stop_flag_;
 		std::vector<int> tree_sample_randoms_;
 	};
 
+	// Root parallelization: each group of threads grows its own pair of trees,
+	// sampled with its own seeds (see AIController). The groups never touch
+	// each other's trees, so they do not contend on any lock. The decisions
+	// are made on the visit counts summed over the groups, along the path of
+	// the actions chosen so far.
 	class AICompetitor : public ICompetitor {
+	private:
+		using TreeNode = mcts::builder::TreeBuilder::TreeNode;
+
 	public:
-		AICompetitor() : root_node_(nullptr), node_(nullptr), controller_() {}
+		AICompetitor(int groups = 1) :
+			groups_(std::max(groups, 1)), controllers_(), root_nodes_(), nodes_(),
+			limits_(), time_manager_(), last_stop_reason_(TimeManager::kStopRequested), last_iterations_(0)
+		{}
 
 		AICompetitor(AICompetitor const&) = delete;
 		AICompetitor & operator=(AICompetitor const&) = delete;
 
+		// The limits of each move, see TimeManager
+		// With a limit, the thinking stops early once the move cannot change.
+		void SetLimits(TimeManager::Limits const& limits) { limits_ = limits; }
+
+		// The trees of the last move are reused if 'state' is found in them
+		// The threads are spread over the groups, with at least one thread in
+		// each group.
+		// 'cb' is given the iterations done in this call, by all the groups;
+		// returns false to stop
 		void Think(state::State const& state, int threads, int seed, int tree_samples, std::function<bool(uint64_t)> cb) {
-			auto continue_checker = [&]() {
-				uint64_t iterations = controller_->GetStatistic().GetSuccededIterates();
-				return cb(iterations);
+			std::mt19937 rand(seed);
+			int groups = std::max(std::min(groups_, threads), 1);
+			controllers_.resize(groups);
+
+			std::vector<uint64_t> start_iterations;
+			for (int group = 0; group < groups; ++group) {
+				auto & controller = controllers_[group];
+				if (!controller || !controller->UpdateRoot(state)) {
+					controller.reset(new AIController(tree_samples, rand));
+				}
+				start_iterations.push_back(controller->GetStatistic().GetSuccededIterates());
+			}
+
+			auto iterations_getter = [&]() {
+				uint64_t iterations = 0;
+				for (int group = 0; group < groups; ++group) {
+					iterations += controllers_[group]->GetStatistic().GetSuccededIterates() - start_iterations[group];
+				}
+				return iterations;
 			};
 
-			std::mt19937 rand(seed);
-			controller_.reset(new AIController(tree_samples, rand));
-			controller_->Run(threads, rand(), [&](int seed) {
-				(void)seed;
-				return state;
-			});
+			state::PlayerIdentifier side = state.GetCurrentPlayerId();
+			auto root_visits_getter = [&](std::vector<int64_t> & visits) {
+				std::vector<TreeNode const*> roots;
+				for (auto & controller : controllers_) roots.push_back(controller->GetRootNode(side));
+				for (auto const& item : SumChosenTimes(roots, [](int) { return true; })) {
+					visits.push_back(item.second);
+				}
+			};
 
-			while (true) {
-				if (!continue_checker()) break;
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			int total_threads = 0;
+			for (int group = 0; group < groups; ++group) {
+				int group_threads = std::max(threads / groups + (group < threads % groups ? 1 : 0), 1);
+				controllers_[group]->Run(group_threads, rand(), state);
+				total_threads += group_threads;
 			}
-			controller_->WaitUntilStopped();
 
-			node_ = controller_->GetRootNode(state.GetCurrentPlayerId());
-			root_node_ = node_;
-		}
+			TimeManager::Limits limits = limits_;
+			limits.threads = total_threads;
+			time_manager_.Start(limits);
+			last_stop_reason_ = time_manager_.Wait(iterations_getter, root_visits_getter, cb);
 
-		int GetMainAction() final {
-			assert(root_node_ == node_);
-			assert(node_);
-			assert(node_->GetActionType().GetType() == mcts::ActionType::kMainAction);
+			// Signal all groups before waiting on any of them
+			for (auto & controller : controllers_) controller->NotifyStop();
+			for (auto & controller : controllers_) controller->WaitUntilStopped();
 
-			int best_choice = -1;
-			double best_chosen_times = -std::numeric_limits<double>::infinity();
-			mcts::builder::TreeBuilder::TreeNode const* best_node = nullptr;
-			root_node_->ForEachChild([&](int choice, mcts::selection::ChildType const& child) {
-				double chosen_times = (double)child.GetEdgeAddon().GetChosenTimes();
-				if (chosen_times > best_chosen_times) {
-					best_chosen_times = chosen_times;
-					best_choice = choice;
-					best_node = child.GetNode();
-				}
-				return true;
-			});
+			last_iterations_ = iterations_getter();
 
-			node_ = best_node;
+			root_nodes_.clear();
+			for (auto & controller : controllers_) {
+				root_nodes_.push_back(controller->GetRootNode(side));
+			}
+			nodes_ = root_nodes_;
+		}
 
-			return best_choice;
+		// Why, and after how many iterations, the last Think() stopped
+		TimeManager::StopReason GetLastStopReason() const { return last_stop_reason_; }
+		uint64_t GetLastIterations() const { return last_iterations_; }
+
+		int GetMainAction() final {
+			assert(root_nodes_ == nodes_);
+			assert(!nodes_.empty() && nodes_[0]);
+			assert(nodes_[0]->GetActionType().GetType() == mcts::ActionType::kMainAction);
+
+			return ChooseMostVisited([](int) { return true; });
 		}
 
 		mcts::board::BoardActionAnalyzer GetActionApplier() final {
-			return root_node_->GetAddon().action_analyzer;
+			return root_nodes_[0]->GetAddon().action_analyzer;
 		}
 
 		int GetSubAction(mcts::ActionType::Types action_type, mcts::board::ActionChoices action_choices) final {
-			assert(node_);
-
-			if (node_->GetActionType() != action_type) {
-				assert(false);
-				throw std::runtime_error("Action type not match");
+			for (auto node : nodes_) {
+				if (node && node->GetActionType() != action_type) {
+					assert(false);
+					throw std::runtime_error("Action type not match");
+				}
 			}
 
 			auto CanBeChosen = [&](int choice) {
@@ -172,32 +430,73 @@ namespace ui
 				return false;
 			};
 
-			int best_choice = -1;
-			double best_chosen_times = -std::numeric_limits<double>::infinity();
-			mcts::builder::TreeBuilder::TreeNode const* best_node = nullptr;
-			node_->ForEachChild([&](int choice, mcts::selection::ChildType const& child) {
-				if (!CanBeChosen(choice)) return true;
-
-				double chosen_times = (double)child.GetEdgeAddon().GetChosenTimes();
-				if (chosen_times > best_chosen_times) {
-					best_chosen_times = chosen_times;
-					best_choice = choice;
-					best_node = child.GetNode();
-				}
-				return true;
-			});
-
+			int best_choice = ChooseMostVisited(CanBeChosen);
 			if (best_choice < 0) {
 				throw std::runtime_error("No any choice is evaluated.");
 			}
+			return best_choice;
+		}
+
+	private:
+		// Sums the chosen times of each choice over the nodes, in the order the
+		// choices are first seen
+		// Can be called while the trees are growing
+		template <class ChoiceFilter>
+		static std::vector<std::pair<int, int64_t>> SumChosenTimes(
+			std::vector<TreeNode const*> const& nodes, ChoiceFilter && filter)
+		{
+			std::vector<std::pair<int, int64_t>> chosen_times;
+			for (auto node : nodes) {
+				if (!node) continue;
+				node->ForEachChild([&](int choice, mcts::selection::ChildType const& child) {
+					if (!filter(choice)) return true;
+
+					auto it = std::find_if(chosen_times.begin(), chosen_times.end(),
+						[choice](auto const& item) { return item.first == choice; });
+					if (it == chosen_times.end()) {
+						chosen_times.emplace_back(choice, 0);
+						it = chosen_times.end() - 1;
+					}
+					it->second += child.GetEdgeAddon().GetChosenTimes();
+					return true;
+				});
+			}
+			return chosen_times;
+		}
+
+		// Steps every group to the child of the choice with the most chosen
+		// times, summed over the groups
+		// A group which never expanded the choice follows with a null node, and
+		// takes no part in the later sub-actions.
+		template <class ChoiceFilter>
+		int ChooseMostVisited(ChoiceFilter && filter) {
+			auto chosen_times = SumChosenTimes(nodes_, filter);
 
-			node_ = best_node;
+			int best_choice = -1;
+			int64_t best_chosen_times = -1;
+			for (auto const& item : chosen_times) {
+				if (item.second > best_chosen_times) {
+					best_chosen_times = item.second;
+					best_choice = item.first;
+				}
+			}
+			if (best_choice < 0) return best_choice;
+
+			for (auto & node : nodes_) {
+				if (!node) continue;
+				node = node->GetChildNode(best_choice);
+			}
 			return best_choice;
 		}
 
 	private:
-		mcts::builder::TreeBuilder::TreeNode const* root_node_;
-		mcts::builder::TreeBuilder::TreeNode const* node_;
-		std::unique_ptr<AIController> controller_;
+		int const groups_;
+		std::vector<std::unique_ptr<AIController>> controllers_;
+		std::vector<TreeNode const*> root_nodes_;
+		std::vector<TreeNode const*> nodes_;
+		TimeManager::Limits limits_;
+		TimeManager time_manager_;
+		TimeManager::StopReason last_stop_reason_;
+		uint64_t last_iterations_;
 	};
 }
\ No newline at end of file
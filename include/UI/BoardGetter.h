@@ -1,9 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <random>
 #include <sstream>
 #include <string>
 #include <shared_mutex>
+#include <unordered_map>
 
 #include <json/json.h>
 
@@ -21,7 +23,8 @@ namespace ui
 
 		BoardGetter(GameEngineLogger & logger) :
 			lock_(), logger_(logger), parser_(logger), action_apply_helper_(),
-			board_raw_(), root_sample_count_(kDefaultRootSampleCount), need_restart_ai_()
+			board_raw_(), root_sample_count_(kDefaultRootSampleCount),
+			need_restart_ai_(), board_changed_(), root_samples_()
 		{}
 
 		// @note Should be set before running
@@ -45,8 +48,8 @@ namespace ui
 			logger_.Log("Updating board.");
 			board_raw_ = board_str;
 
-			// TODO: reuse MCTS tree
-			need_restart_ai_ = true;
+			// the AI tries to continue on the existing trees in the next run
+			board_changed_ = true;
 
 			return 0;
 		}
@@ -58,22 +61,70 @@ namespace ui
 			std::mt19937 rand(seed);
 			parser_.ChangeBoard(board_raw_, rand);
 			
-			if (!controller || need_restart_ai_) {
-				controller.reset(new ui::AIController(root_sample_count_, rand));
+			bool restart = !controller || need_restart_ai_;
+			if (!restart && board_changed_) {
 				action_apply_helper_.ClearChoices();
+				if (controller->UpdateRoot(LockedGetStartBoard(rand()))) {
+					std::stringstream ss;
+					ss << "Reuse the MCTS trees (" << controller->GetRootVisits(state::kPlayerFirst)
+						<< " iterations on the new root).";
+					logger_.Log(ss.str());
+				}
+				else {
+					restart = true;
+				}
 			}
-			else {
-				// TODO: re-use MCTS tree
-				return 0;
+
+			if (restart) {
+				controller.reset(new ui::AIController(root_sample_count_, rand));
+				action_apply_helper_.ClearChoices();
 			}
 
+			PrepareRootSamples(controller->GetTreeSampleSeeds());
+
+			need_restart_ai_ = false;
+			board_changed_ = false;
 			return 0;
 		}
 
+		// The start board of 'seed', with the choices applied, as prepared in
+		// PrepareToRun() for the seeds of the controller
+		// Thread safety: the samples are only changed in PrepareToRun(), so they
+		// can be read without the lock while the controller is running
+		state::State const& GetRootSample(int seed) const
+		{
+			auto it = root_samples_.find(seed);
+			if (it == root_samples_.end()) {
+				assert(false);
+				throw std::runtime_error("root sample is not prepared");
+			}
+			return *it->second;
+		}
+
 		state::State GetStartBoard(int seed)
 		{
 			std::shared_lock<std::shared_mutex> lock(lock_);
+			return LockedGetStartBoard(seed);
+		}
+
+	private:
+		// Builds the start boards once, so the iterations only fork them
+		void PrepareRootSamples(std::vector<int> const& seeds)
+		{
+			root_samples_.clear();
+			for (int seed : seeds) {
+				if (root_samples_.count(seed)) continue;
+				auto sample = std::make_unique<state::State>(LockedGetStartBoard(seed));
+
+				// Hash the changed cards once here; a fork of a dirty card would
+				// copy the card to clear its dirty flag (see state::Cards::Manager)
+				sample->GetViewHash(state::kPlayerFirst);
+				root_samples_.emplace(seed, std::move(sample));
+			}
+		}
 
+		state::State LockedGetStartBoard(int seed)
+		{
 			state::State game_state = parser_.GetStartBoard(seed);
 			action_apply_helper_.ApplyChoices(game_state);
 			return game_state;
@@ -87,5 +138,7 @@ namespace ui
 		std::string board_raw_;
 		int root_sample_count_;
 		bool need_restart_ai_;
+		bool board_changed_;
+		std::unordered_map<int, std::unique_ptr<state::State>> root_samples_;
 	};
 }
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include "MCTS/board/ActionParameterGetter.h"
 #include "MCTS/board/BoardActionAnalyzer.h"
 #include "MCTS/board/RandomGenerator.h"
+#include "NeuralNetworkStateEncoder.h"
+#include "NeuralNetworkTrainData.h"
 
 namespace ui
 {
@@ -44,10 +46,11 @@ namespace ui
 	class CompetitionRecorder
 	{
 	public:
-		CompetitionRecorder(std::mt19937 & rand) : rand_(rand), json_() {}
+		CompetitionRecorder(std::mt19937 & rand) : rand_(rand), json_(), samples_() {}
 
 		void Start() {
 			json_.clear();
+			samples_.clear();
 		}
 
 		void RecordMainAction(state::State const& state, mcts::board::BoardActionAnalyzer const& analyzer, int action)
@@ -60,6 +63,13 @@ namespace ui
 			obj["choice"] = GetMainOpString(op);
 
 			json_.append(obj);
+
+			// Labeled when the game ends; for now, whether the first player is to move
+			NeuralNetworkTrainData::Sample sample;
+			NeuralNetworkStateEncoder::Encode(state, sample.input);
+			sample.label = state.GetCurrentPlayerId().IsFirst() ? 1 : -1;
+			sample.turn = state.GetTurn();
+			samples_.push_back(sample);
 		}
 
 		void RecordRandomAction(int exclusive_max, int action) {
@@ -113,13 +123,22 @@ namespace ui
 
 			std::ostringstream ss;
 			int postfix = rand() % 90000 + 10000;
-			ss << buffer << "-" << postfix << ".json";
+			ss << buffer << "-" << postfix;
 			std::string filename = ss.str();
 
-			std::ofstream fs(filename, std::ofstream::trunc);
+			std::ofstream fs(filename + ".json", std::ofstream::trunc);
 			Json::StyledStreamWriter json_writer;
 			json_writer.write(fs, json_);
 			fs.close();
+
+			// Note: AI is always helping first player
+			bool first_player_wins = (result.type_ == mcts::Result::kResultWin);
+			NeuralNetworkTrainData::Writer writer(filename + ".bin");
+			for (auto & sample : samples_) {
+				if (!first_player_wins) sample.label = -sample.label;
+				writer.Write(sample);
+			}
+			writer.Close();
 		}
 
 	private:
@@ -187,6 +206,7 @@ namespace ui
 	private:
 		std::mt19937 & rand_;
 		Json::Value json_;
+		std::vector<NeuralNetworkTrainData::Sample> samples_;
 	};
 
 	class CompetitionGuide
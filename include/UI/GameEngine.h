@@ -24,7 +24,19 @@ namespace ui
 		int InteractiveShell(std::string const& cmd);
 
 		int Run(int seconds, int threads);
+
+		// Keeps searching on the last run until NotifyStop(), e.g., in the
+		// opponent's turn; the next Run() continues on the trees grown
+		int Ponder(int threads);
+
+		// Stops the Run() or Ponder() in progress, or the next one started
+		// before ResetStop()
 		int NotifyStop();
+
+		// Should be called before a Run() or Ponder() is started in another
+		// thread, so a NotifyStop() after that is never lost
+		int ResetStop();
+
 		std::string GetBestChoice();
 
 	private:
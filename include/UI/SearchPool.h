@@ -0,0 +1,214 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "MCTS/MOMCTS.h"
+
+namespace ui
+{
+	// Long-lived search workers, shared by the AI controllers (see AIController)
+	// A search is dispatched as a task asking for some threads. Each worker keeps
+	// its scratch (an MOMCTS with its tree builders, flow contexts and policies)
+	// across the searches, and rebinds it onto the trees of the search it runs.
+	// Scheduling:
+	//    The busy workers are at most the threads asked by the submitted
+	//    searches, so the threads of a search which is stopped but not yet
+	//    removed are lent to the others.
+	//    A worker joins the running search with the fewest workers per thread
+	//    asked. It steals into a search above the threads asked (up to
+	//    'max_threads') only with the threads lent, and leaves such a search as
+	//    soon as another one is short of workers, or the threads are taken back.
+	// The pool grows to the threads asked by the submitted searches, and never
+	// shrinks.
+	// Thread safety: all public methods are thread-safe
+	class SearchPool
+	{
+	public:
+		// The scratch of a worker
+		struct Scratch {
+			Scratch() : selection_rand(), simulation_rand(), mcts() {}
+
+			std::mt19937 selection_rand;
+			std::mt19937 simulation_rand;
+			std::unique_ptr<mcts::MOMCTS> mcts; // created by the first search run
+		};
+
+		class Search
+		{
+		public:
+			virtual ~Search() {}
+
+			// Runs the iterations on a worker, until the search is stopped or
+			// 'should_leave' returns true
+			// 'slot' is in [0, max_threads), and is not used by another worker
+			// of this search at the same time.
+			virtual void Run(Scratch & scratch, int slot, std::function<bool()> const& should_leave) = 0;
+
+			virtual bool IsStopping() const = 0;
+		};
+
+		SearchPool() :
+			mutex_(), cv_(), left_cv_(), searches_(), workers_(), shutdown_(false),
+			asked_threads_(0), busy_workers_(0), rebalance_(false)
+		{}
+
+		SearchPool(SearchPool const&) = delete;
+		SearchPool & operator=(SearchPool const&) = delete;
+
+		~SearchPool() {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				assert(searches_.empty());
+				shutdown_ = true;
+			}
+			cv_.notify_all();
+			for (auto & worker : workers_) worker.join();
+		}
+
+		// The pool shared in a process
+		static SearchPool & GetShared() {
+			static SearchPool pool;
+			return pool;
+		}
+
+		size_t GetWorkerCount() const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return workers_.size();
+		}
+
+		// Starts to run 'search' on 'threads' workers, and on up to 'max_threads'
+		// workers when some are idle
+		// The search should be removed by Remove() before it is destroyed.
+		void Submit(Search & search, int threads, int max_threads) {
+			assert(threads > 0);
+			assert(max_threads >= threads);
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				searches_.push_back(Entry(search, threads, max_threads));
+				asked_threads_ += threads;
+
+				while ((int)workers_.size() < asked_threads_) {
+					workers_.emplace_back([this]() { WorkerMain(); });
+				}
+
+				UpdateRebalance();
+			}
+			cv_.notify_all();
+		}
+
+		// Blocks until no worker runs 'search', and removes it
+		// The search should be stopped before; see Search::IsStopping().
+		void Remove(Search & search) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			auto it = std::find_if(searches_.begin(), searches_.end(),
+				[&](Entry const& entry) { return entry.search == &search; });
+			if (it == searches_.end()) return;
+
+			assert(search.IsStopping());
+			left_cv_.wait(lock, [&]() { return it->workers == 0; });
+			asked_threads_ -= it->threads;
+			searches_.erase(it);
+			UpdateRebalance();
+		}
+
+	private:
+		struct Entry {
+			Entry(Search & new_search, int new_threads, int max_threads) :
+				search(&new_search), threads(new_threads), workers(0), slots(max_threads, false)
+			{}
+
+			Entry(Entry const&) = default;
+			Entry & operator=(Entry const&) = default;
+
+			Search * search;
+			int threads;
+			int workers;
+			std::vector<bool> slots; // in use
+		};
+
+		void WorkerMain() {
+			Scratch scratch;
+
+			std::unique_lock<std::mutex> lock(mutex_);
+			while (true) {
+				if (shutdown_) return;
+
+				Entry * entry = PickSearch();
+				if (!entry) {
+					cv_.wait(lock);
+					continue;
+				}
+
+				int slot = (int)(std::find(entry->slots.begin(), entry->slots.end(), false) - entry->slots.begin());
+				entry->slots[slot] = true;
+				++entry->workers;
+				++busy_workers_;
+				UpdateRebalance();
+				lock.unlock();
+
+				entry->search->Run(scratch, slot, [this, entry]() {
+					if (!rebalance_.load(std::memory_order_relaxed)) return false;
+					std::lock_guard<std::mutex> lock(mutex_);
+					return entry->workers > entry->threads;
+				});
+
+				lock.lock();
+				entry->slots[slot] = false;
+				--entry->workers;
+				--busy_workers_;
+				UpdateRebalance();
+				left_cv_.notify_all();
+			}
+		}
+
+		// Should be called with 'mutex_' held
+		Entry * PickSearch() {
+			if (busy_workers_ >= asked_threads_) return nullptr;
+
+			Entry * best = nullptr;
+			for (auto & entry : searches_) {
+				if (entry.workers >= (int)entry.slots.size()) continue;
+				if (entry.search->IsStopping()) continue;
+
+				// fewest workers per thread asked
+				if (!best || entry.workers * best->threads < best->workers * entry.threads) {
+					best = &entry;
+				}
+			}
+			return best;
+		}
+
+		// The workers above the threads asked should leave when
+		//    some running search has fewer workers than asked, or
+		//    the threads lent are taken back
+		// Should be called with 'mutex_' held
+		void UpdateRebalance() {
+			bool value = busy_workers_ > asked_threads_;
+			for (auto const& entry : searches_) {
+				if (entry.workers < entry.threads && !entry.search->IsStopping()) value = true;
+			}
+			rebalance_.store(value, std::memory_order_relaxed);
+		}
+
+	private:
+		mutable std::mutex mutex_;
+		std::condition_variable cv_; // for the idle workers
+		std::condition_variable left_cv_; // for Remove()
+		std::list<Entry> searches_; // elements are not moved
+		std::vector<std::thread> workers_;
+		bool shutdown_;
+		int asked_threads_; // by the submitted searches
+		int busy_workers_;
+		std::atomic<bool> rebalance_;
+	};
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace ui
+{
+	// Decides when to stop thinking on a move
+	//   1. The iteration limit and the time limit.
+	//   2. Early stop: the most visited root choice cannot be overtaken by the
+	//      iterations left, since an iteration adds one visit to one root choice.
+	//      Within a time limit, the iterations left are estimated from the rate
+	//      so far, with a margin.
+	//   3. Extension: at the time limit, a complex move (many root choices, with
+	//      the visits spread over them) is given up to 'max_extension' of the
+	//      time limit more.
+	// The caller blocks in Wait() on a condition variable. It is woken for the
+	// next check, at the deadline, or by NotifyStop().
+	// Thread safety: NotifyStop() can be called from any thread; the others
+	// should be called from the thread running the search.
+	class TimeManager
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Limits {
+			uint64_t iterations = 0; // 0 for no limit
+			Clock::duration time = Clock::duration::zero(); // zero for no limit
+			double max_extension = 0.0; // in multiples of 'time'
+			int threads = 1; // each might finish one more iteration after the stop
+		};
+
+		enum StopReason {
+			kStopRequested, // by NotifyStop(), or by the caller's checker
+			kIterationLimit,
+			kTimeLimit,
+			kDecided // the best root choice cannot change
+		};
+
+		static constexpr auto kCheckInterval = std::chrono::milliseconds(10);
+
+	private:
+		// The visit rate might go up later, e.g., when the trees are warmed up
+		static constexpr double kRateMargin = 1.5;
+
+		// The root choices with which a move is taken as fully complex
+		static constexpr int kWideBranching = 8;
+
+	public:
+		TimeManager() :
+			mutex_(), cv_(), stop_notified_(false),
+			limits_(), start_(), deadline_(), extended_(false), extension_(0.0), root_visits_()
+		{}
+
+		TimeManager(TimeManager const&) = delete;
+		TimeManager & operator=(TimeManager const&) = delete;
+
+		// Times the search from now
+		void Start(Limits const& limits) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_notified_ = false;
+			limits_ = limits;
+			start_ = Clock::now();
+			deadline_ = start_ + limits.time;
+			extended_ = false;
+			extension_ = 0.0;
+		}
+
+		void NotifyStop() {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_notified_ = true;
+			}
+			cv_.notify_all();
+		}
+
+		// Blocks until the search should stop
+		// 'iterations_getter': uint64_t(), the iterations done since Start()
+		// 'root_visits_getter': void(std::vector<int64_t> & visits), appends the
+		//     chosen times of each root choice
+		// 'continue_checker': bool(uint64_t iterations), false to stop
+		template <class IterationsGetter, class RootVisitsGetter, class ContinueChecker>
+		StopReason Wait(IterationsGetter && iterations_getter, RootVisitsGetter && root_visits_getter,
+			ContinueChecker && continue_checker)
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			while (true) {
+				if (stop_notified_) return kStopRequested;
+
+				uint64_t iterations = iterations_getter();
+				if (!continue_checker(iterations)) return kStopRequested;
+
+				root_visits_.clear();
+				root_visits_getter(root_visits_);
+
+				auto now = Clock::now();
+				StopReason reason;
+				if (ShouldStop(now, iterations, &reason)) return reason;
+
+				auto wake_time = now + kCheckInterval;
+				if (HasTimeLimit()) wake_time = std::min(wake_time, deadline_);
+				cv_.wait_until(lock, wake_time, [this]() { return stop_notified_; });
+			}
+		}
+
+		// Valid when there is a time limit; moved on by an extension
+		Clock::time_point GetDeadline() const { return deadline_; }
+
+		// The extension granted at the time limit, in multiples of the limit
+		double GetExtension() const { return extension_; }
+
+	private:
+		bool HasTimeLimit() const { return limits_.time > Clock::duration::zero(); }
+
+		bool ShouldStop(Clock::time_point now, uint64_t iterations, StopReason * reason) {
+			if (limits_.iterations > 0 && iterations >= limits_.iterations) {
+				*reason = kIterationLimit;
+				return true;
+			}
+
+			if (HasTimeLimit() && now >= deadline_) {
+				if (!extended_) {
+					// Decided only once, at the time limit
+					extended_ = true;
+					extension_ = limits_.max_extension * GetComplexity();
+					deadline_ = start_ + std::chrono::duration_cast<Clock::duration>(limits_.time * (1.0 + extension_));
+				}
+				if (now >= deadline_) {
+					*reason = kTimeLimit;
+					return true;
+				}
+			}
+
+			uint64_t iterations_left = 0;
+			if (!GetIterationsLeft(now, iterations, &iterations_left)) return false;
+			if (CannotBeOvertaken(iterations_left + std::max(limits_.threads, 1))) {
+				*reason = kDecided;
+				return true;
+			}
+			return false;
+		}
+
+		// Returns false if the iterations left are not bounded
+		bool GetIterationsLeft(Clock::time_point now, uint64_t iterations, uint64_t * left) const {
+			bool bounded = false;
+			uint64_t result = std::numeric_limits<uint64_t>::max();
+
+			if (limits_.iterations > 0) {
+				bounded = true;
+				result = limits_.iterations - std::min(iterations, limits_.iterations);
+			}
+
+			if (HasTimeLimit()) {
+				double elapsed = std::chrono::duration<double>(now - start_).count();
+				if (elapsed <= 0.0 || iterations == 0) {
+					*left = result; // no rate yet
+					return bounded;
+				}
+
+				// Before the extension is decided, it might be granted in full
+				auto deadline = deadline_;
+				if (!extended_) {
+					deadline = start_ + std::chrono::duration_cast<Clock::duration>(
+						limits_.time * (1.0 + limits_.max_extension));
+				}
+				double time_left = std::max(std::chrono::duration<double>(deadline - now).count(), 0.0);
+				double rate = iterations / elapsed;
+
+				bounded = true;
+				result = std::min(result, (uint64_t)std::ceil(rate * time_left * kRateMargin));
+			}
+
+			*left = result;
+			return bounded;
+		}
+
+		bool CannotBeOvertaken(uint64_t iterations_left) const {
+			int64_t best = 0;
+			int64_t second = 0;
+			for (int64_t visits : root_visits_) {
+				if (visits > best) {
+					second = best;
+					best = visits;
+				}
+				else if (visits > second) {
+					second = visits;
+				}
+			}
+			if (best == 0) return false;
+			return (uint64_t)(best - second) > iterations_left;
+		}
+
+		// In [0, 1]: the entropy of the root visits, normalized by the most it
+		// can be, and scaled down for few root choices
+		double GetComplexity() const {
+			int64_t total = 0;
+			int choices = 0;
+			for (int64_t visits : root_visits_) {
+				if (visits <= 0) continue;
+				total += visits;
+				++choices;
+			}
+			if (choices < 2) return 0.0;
+
+			double entropy = 0.0;
+			for (int64_t visits : root_visits_) {
+				if (visits <= 0) continue;
+				double p = (double)visits / total;
+				entropy -= p * std::log(p);
+			}
+
+			double spread = entropy / std::log((double)choices);
+			double branching = std::min(std::log((double)choices) / std::log((double)kWideBranching), 1.0);
+			return std::min(std::max(spread * branching, 0.0), 1.0);
+		}
+
+	private:
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		bool stop_notified_;
+
+		Limits limits_;
+		Clock::time_point start_;
+		Clock::time_point deadline_;
+		bool extended_;
+		double extension_;
+		std::vector<int64_t> root_visits_;
+	};
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Utils
+{
+	// A bump-pointer arena
+	// Thread safety:
+	//    Allocate() and Create() should be called only from the owner thread
+	//    The memory usage counters can be read from any thread
+	// Objects are never released individually. All of them are released
+	// when the arena is cleared (or destroyed): the destructors of the
+	// non-trivially-destructible objects are invoked linearly (in reverse
+	// creation order), and then the blocks are returned to the system.
+	class Arena
+	{
+	public:
+		static constexpr size_t kBlockSize = 1 << 20;
+
+		Arena() :
+			blocks_(nullptr), current_(nullptr), rest_(0), finalizers_(nullptr),
+			allocated_bytes_(0), reserved_bytes_(0)
+		{}
+
+		Arena(Arena const&) = delete;
+		Arena & operator=(Arena const&) = delete;
+
+		~Arena() { Clear(); }
+
+		void * Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+			assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+			size_t padding = (alignment - (reinterpret_cast<uintptr_t>(current_) & (alignment - 1))) & (alignment - 1);
+			if (!current_ || padding + size > rest_) {
+				NewBlock(size + alignment);
+				padding = (alignment - (reinterpret_cast<uintptr_t>(current_) & (alignment - 1))) & (alignment - 1);
+			}
+			assert(padding + size <= rest_);
+
+			char * ptr = current_ + padding;
+			current_ += padding + size;
+			rest_ -= padding + size;
+			allocated_bytes_.store(allocated_bytes_.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+			return ptr;
+		}
+
+		template <class T, class... Args>
+		T * Create(Args&&... args) {
+			void * ptr = Allocate(sizeof(T), alignof(T));
+			T * obj = new (ptr) T(std::forward<Args>(args)...);
+
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				Finalizer * finalizer = new (Allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer;
+				finalizer->destroy = [](void * p) { static_cast<T*>(p)->~T(); };
+				finalizer->object = obj;
+				finalizer->next = finalizers_;
+				finalizers_ = finalizer;
+			}
+			return obj;
+		}
+
+		// Invoke the destructors of the created objects, but keep the memory
+		// Useful when objects in several arenas refer to each other: finalize all
+		// of the arenas first, and then release them.
+		void RunFinalizers() {
+			for (Finalizer * finalizer = finalizers_; finalizer; finalizer = finalizer->next) {
+				finalizer->destroy(finalizer->object);
+			}
+			finalizers_ = nullptr;
+		}
+
+		void Clear() {
+			RunFinalizers();
+
+			while (blocks_) {
+				Block * next = blocks_->next;
+				std::free(blocks_);
+				blocks_ = next;
+			}
+			current_ = nullptr;
+			rest_ = 0;
+			allocated_bytes_.store(0, std::memory_order_relaxed);
+			reserved_bytes_.store(0, std::memory_order_relaxed);
+		}
+
+		// bytes handed out to callers
+		size_t GetAllocatedBytes() const { return allocated_bytes_.load(std::memory_order_relaxed); }
+
+		// bytes obtained from the system
+		size_t GetReservedBytes() const { return reserved_bytes_.load(std::memory_order_relaxed); }
+
+	public:
+		// The arena used by Create/ArenaAllocator in the current thread
+		static Arena * GetThreadArena() { return ThreadArenaSlot(); }
+
+		// Install an arena as the thread arena within a scope
+		class ThreadScope
+		{
+		public:
+			ThreadScope(Arena & arena) : previous_(ThreadArenaSlot()) {
+				ThreadArenaSlot() = &arena;
+			}
+			~ThreadScope() { ThreadArenaSlot() = previous_; }
+
+			ThreadScope(ThreadScope const&) = delete;
+			ThreadScope & operator=(ThreadScope const&) = delete;
+
+		private:
+			Arena * previous_;
+		};
+
+	private:
+		struct Block {
+			Block * next;
+		};
+
+		struct Finalizer {
+			void(*destroy)(void *);
+			void * object;
+			Finalizer * next;
+		};
+
+		static Arena * & ThreadArenaSlot() {
+			thread_local Arena * arena = nullptr;
+			return arena;
+		}
+
+		void NewBlock(size_t min_size) {
+			size_t size = sizeof(Block) + (min_size > kBlockSize ? min_size : kBlockSize);
+			void * mem = std::malloc(size);
+			if (!mem) throw std::bad_alloc();
+
+			Block * block = static_cast<Block *>(mem);
+			block->next = blocks_;
+			blocks_ = block;
+
+			current_ = static_cast<char *>(mem) + sizeof(Block);
+			rest_ = size - sizeof(Block);
+			reserved_bytes_.store(reserved_bytes_.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+		}
+
+	private:
+		Block * blocks_;
+		char * current_;
+		size_t rest_;
+		Finalizer * finalizers_;
+
+		// only written by the owner thread
+		std::atomic<size_t> allocated_bytes_;
+		std::atomic<size_t> reserved_bytes_;
+	};
+
+	// A stateless allocator allocating from the thread arena
+	// Deallocation is a no-op; memory is reclaimed when the arena is cleared.
+	template <class T>
+	class ArenaAllocator
+	{
+	public:
+		using value_type = T;
+
+		ArenaAllocator() = default;
+		template <class U> ArenaAllocator(ArenaAllocator<U> const&) {}
+
+		T * allocate(size_t n) {
+			Arena * arena = Arena::GetThreadArena();
+			assert(arena);
+			return static_cast<T *>(arena->Allocate(sizeof(T) * n, alignof(T)));
+		}
+		void deallocate(T *, size_t) {}
+
+		template <class U> bool operator==(ArenaAllocator<U> const&) const { return true; }
+		template <class U> bool operator!=(ArenaAllocator<U> const&) const { return false; }
+	};
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
 namespace Utils
 {
 	class HashCombine
@@ -10,5 +15,34 @@ namespace Utils
 		{
 			seed ^= std::hash<T>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 		}
+
+		// A 64-bit hash over raw bytes, eight bytes at a time
+		// Only meaningful for objects without padding bits
+		//    (i.e., std::has_unique_object_representations)
+		static std::uint64_t hash_bytes(void const* data, std::size_t size)
+		{
+			constexpr std::uint64_t kMul = 0x9ddfea08eb382d69ULL;
+			auto mix = [](std::uint64_t h, std::uint64_t w) {
+				h = (h ^ w) * kMul;
+				return h ^ (h >> 47);
+			};
+
+			unsigned char const* p = static_cast<unsigned char const*>(data);
+			std::uint64_t h = size * kMul;
+			for (; size >= 8; p += 8, size -= 8) {
+				std::uint64_t w;
+				std::memcpy(&w, p, 8);
+				h = mix(h, w);
+			}
+			if (size > 0) {
+				std::uint64_t w = 0;
+				std::memcpy(&w, p, size);
+				h = mix(h, w);
+			}
+
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdULL;
+			return h ^ (h >> 33);
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Utils
+{
+	// A callable stored inline: a function pointer, plus a small buffer for the
+	// captured values
+	// Unlike std::function, the functor should be trivially copyable and
+	// trivially destructible, so this is trivially copyable as well. A container
+	// of these is cloned by memcpy, and never allocates.
+	template <typename Signature, size_t Capacity = 24> class InlineFunction;
+
+	template <typename R, typename... Args, size_t Capacity>
+	class InlineFunction<R(Args...), Capacity>
+	{
+	public:
+		InlineFunction() : invoker_(nullptr) {}
+
+		template <typename Functor, typename = std::enable_if_t<
+			!std::is_same_v<std::decay_t<Functor>, InlineFunction> &&
+			std::is_invocable_r_v<R, std::decay_t<Functor>&, Args...>>>
+		InlineFunction(Functor&& functor) : invoker_(&Invoke<std::decay_t<Functor>>)
+		{
+			using FunctorType = std::decay_t<Functor>;
+			static_assert(sizeof(FunctorType) <= Capacity, "Too many captured values.");
+			static_assert(alignof(FunctorType) <= alignof(void*), "Over-aligned captured values.");
+			static_assert(std::is_trivially_copyable_v<FunctorType>, "Captured values should be trivially copyable.");
+			static_assert(std::is_trivially_destructible_v<FunctorType>, "Captured values should be trivially destructible.");
+
+			new (storage_) FunctorType(std::forward<Functor>(functor));
+		}
+
+		explicit operator bool() const { return invoker_ != nullptr; }
+
+		// Like std::function, a mutable functor can modify its captured values
+		R operator()(Args... args) const {
+			assert(invoker_);
+			return invoker_(storage_, std::forward<Args>(args)...);
+		}
+
+	private:
+		template <typename FunctorType>
+		static R Invoke(void * storage, Args... args) {
+			return (*std::launder(static_cast<FunctorType*>(storage)))(std::forward<Args>(args)...);
+		}
+
+	private:
+		R(*invoker_)(void *, Args...);
+		alignas(void*) mutable unsigned char storage_[Capacity];
+	};
+}
@@ -1,69 +1,145 @@
 #pragma once
 
+#include <assert.h>
 #include <atomic>
+#include <cstdint>
 #include <shared_mutex>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define UTILS_SPIN_PAUSE() _mm_pause()
+#else
+#define UTILS_SPIN_PAUSE() ((void)0)
+#endif
 
 namespace Utils
 {
-	class SpinLock
+	// Exponential backoff for spin loops
+	// Pause 1, 2, 4, ... times; yield the time slice after that
+	class SpinBackoff
 	{
 	public:
-		SpinLock() : flag_() {}
+		static constexpr int kMaxPauseShift = 6;
+
+		SpinBackoff() : shift_(0) {}
+
+		void Pause() {
+			if (shift_ <= kMaxPauseShift) {
+				for (int i = 0; i < (1 << shift_); ++i) UTILS_SPIN_PAUSE();
+				++shift_;
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+
+		bool IsYielding() const { return shift_ > kMaxPauseShift; }
+
+	private:
+		int shift_;
+	};
+
+	// Called once per lock acquisition which does not succeed in the first try
+	struct NoContentionRecorder {
+		static void ReportContention() {}
+	};
+
+	template <class ContentionRecorder>
+	class BasicSpinLock
+	{
+	public:
+		BasicSpinLock() : flag_(false) {}
 
 		void lock() {
-			while (flag_.test_and_set(std::memory_order_acquire)) {
-				; // spin
+			if (!flag_.exchange(true, std::memory_order_acquire)) return;
+
+			ContentionRecorder::ReportContention();
+			SpinBackoff backoff;
+			while (true) {
+				// spin on a plain load, so the cache line is not bounced between cores
+				while (flag_.load(std::memory_order_relaxed)) backoff.Pause();
+				if (!flag_.exchange(true, std::memory_order_acquire)) return;
 			}
 		}
 
 		void unlock() {
-			flag_.clear(std::memory_order_release);
+			flag_.store(false, std::memory_order_release);
 		}
 
 	private:
-		std::atomic_flag flag_;
+		std::atomic<bool> flag_;
 	};
 
-	class SharedSpinLock
+	// Reader count and writer bits in a single atomic word
+	// Readers are preferred: they share the lock with each other without
+	// waiting for a writer to queue up. A writer failing to get the lock after
+	// the backoff starts yielding sets the pending bit, which stops new
+	// readers from coming in, so a writer is not starved forever.
+	template <class ContentionRecorder>
+	class BasicSharedSpinLock
 	{
+	private:
+		static constexpr std::uint32_t kWriter = 1u << 31;
+		static constexpr std::uint32_t kWriterPending = 1u << 30;
+		static constexpr std::uint32_t kReadersMask = kWriterPending - 1;
+
 	public:
-		SharedSpinLock() : lock_(), writer_(false), readers_(0) {}
+		BasicSharedSpinLock() : state_(0) {}
 
 		void lock() {
+			std::uint32_t expected = 0;
+			if (state_.compare_exchange_weak(expected, kWriter, std::memory_order_acquire)) return;
+
+			ContentionRecorder::ReportContention();
+			SpinBackoff backoff;
 			while (true) {
-				lock_.lock();
-				if (!writer_ && readers_ == 0) break;
-				lock_.unlock();
+				expected = state_.load(std::memory_order_relaxed);
+				if ((expected & ~kWriterPending) == 0) {
+					// clear the pending bit as well
+					if (state_.compare_exchange_weak(expected, kWriter, std::memory_order_acquire)) return;
+					continue;
+				}
+				if (backoff.IsYielding() && !(expected & kWriterPending)) {
+					state_.fetch_or(kWriterPending, std::memory_order_relaxed);
+				}
+				backoff.Pause();
 			}
-			writer_ = true;
-			lock_.unlock();
 		}
 
 		void unlock() {
-			lock_.lock();
-			writer_ = false;
-			lock_.unlock();
+			state_.fetch_and(~kWriter, std::memory_order_release);
 		}
 
 		void lock_shared() {
+			std::uint32_t expected = state_.load(std::memory_order_relaxed);
+			if (!(expected & (kWriter | kWriterPending)) &&
+				state_.compare_exchange_weak(expected, expected + 1, std::memory_order_acquire))
+			{
+				return;
+			}
+
+			ContentionRecorder::ReportContention();
+			SpinBackoff backoff;
 			while (true) {
-				lock_.lock();
-				if (!writer_) break;
-				lock_.unlock();
+				expected = state_.load(std::memory_order_relaxed);
+				if (!(expected & (kWriter | kWriterPending))) {
+					assert((expected & kReadersMask) != kReadersMask);
+					if (state_.compare_exchange_weak(expected, expected + 1, std::memory_order_acquire)) return;
+					continue;
+				}
+				backoff.Pause();
 			}
-			++readers_;
-			lock_.unlock();
 		}
 
 		void unlock_shared() {
-			lock_.lock();
-			--readers_;
-			lock_.unlock();
+			state_.fetch_sub(1, std::memory_order_release);
 		}
 
 	private:
-		SpinLock lock_;
-		bool writer_;
-		int readers_;
+		std::atomic<std::uint32_t> state_;
 	};
-}
\ No newline at end of file
+
+	using SpinLock = BasicSpinLock<NoContentionRecorder>;
+	using SharedSpinLock = BasicSharedSpinLock<NoContentionRecorder>;
+}
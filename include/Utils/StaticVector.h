@@ -0,0 +1,73 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace Utils
+{
+	// A vector with a fixed capacity, and the items stored inline
+	// Used for the short lists with a known upper bound (e.g., the minions
+	// on board), so they never allocate.
+	template <class ItemType, size_t Capacity>
+	class StaticVector
+	{
+		static_assert(std::is_trivially_copyable_v<ItemType>, "Items should be trivially copyable.");
+
+	public:
+		using value_type = ItemType;
+		using iterator = ItemType *;
+		using const_iterator = ItemType const*;
+
+		StaticVector() : size_(0), items_() {}
+
+		template <class Container>
+		explicit StaticVector(Container const& items) : size_(0), items_() {
+			for (auto const& item : items) push_back(item);
+		}
+
+		static constexpr size_t capacity() { return Capacity; }
+		size_t size() const { return size_; }
+		bool empty() const { return size_ == 0; }
+		bool full() const { return size_ >= Capacity; }
+
+		void clear() { size_ = 0; }
+
+		void push_back(ItemType const& item) {
+			assert(size_ < Capacity);
+			items_[size_] = item;
+			++size_;
+		}
+
+		void erase(const_iterator it) {
+			assert(it >= begin() && it < end());
+			iterator pos = begin() + (it - begin());
+			std::copy(pos + 1, end(), pos);
+			--size_;
+		}
+
+		ItemType & operator[](size_t idx) {
+			assert(idx < size_);
+			return items_[idx];
+		}
+		ItemType const& operator[](size_t idx) const {
+			assert(idx < size_);
+			return items_[idx];
+		}
+
+		iterator begin() { return items_.data(); }
+		iterator end() { return items_.data() + size_; }
+		const_iterator begin() const { return items_.data(); }
+		const_iterator end() const { return items_.data() + size_; }
+
+		bool operator==(StaticVector const& rhs) const {
+			return std::equal(begin(), end(), rhs.begin(), rhs.end());
+		}
+		bool operator!=(StaticVector const& rhs) const { return !(*this == rhs); }
+
+	private:
+		size_t size_;
+		std::array<ItemType, Capacity> items_;
+	};
+}
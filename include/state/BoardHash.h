@@ -0,0 +1,89 @@
+#pragma once
+
+#include <assert.h>
+#include <cstdint>
+#include "state/Types.h"
+#include "state/Configs.h"
+
+namespace state
+{
+	// Hash of the board observed by one player (the viewer)
+	// The hash is the sum (mod 2^64) of the contributions of each observable
+	// item. A sum, instead of a xor, is used so identical items (e.g., two
+	// cards with the same id in hand) do not cancel out each other.
+	// This should observe the same fields as mcts::board::BoardView
+	class BoardHash
+	{
+	public:
+		enum Tag : std::uint64_t {
+			kTagTurn = 1,
+			kTagViewer,
+			kTagHero,
+			kTagHeroPower,
+			kTagWeapon,
+			kTagMinion,
+			kTagSelfHandCard,
+			kTagOpponentHandCard,
+			kTagResource,
+			kTagDeck,
+			kTagHeroAttackable,
+			kTagMinionAttackable
+		};
+
+		static std::uint64_t Mix(std::uint64_t v) {
+			// finalizer of splitmix64
+			v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			v = (v ^ (v >> 27)) * 0x94d049bb133111ebULL;
+			return v ^ (v >> 31);
+		}
+
+		template <class... Fields>
+		static std::uint64_t Key(Tag tag, Fields... fields) {
+			std::uint64_t v = Mix(tag);
+			((v = Mix(v ^ (std::uint64_t)(std::int64_t)fields)), ...);
+			return v;
+		}
+
+		static int GetViewerIndex(PlayerSide viewer) {
+			assert(viewer == kPlayerFirst || viewer == kPlayerSecond);
+			return viewer == kPlayerFirst ? 0 : 1;
+		}
+
+		// Contribution of a card; zero if the card is not observable
+		template <class CardType>
+		static std::uint64_t GetCardContribution(CardType const& card, PlayerSide viewer) {
+			bool is_self = (card.GetPlayerIdentifier().GetSide() == viewer);
+
+			switch (card.GetZone()) {
+			case kCardZoneHand:
+				if (!is_self) return Key(kTagOpponentHandCard);
+				if constexpr (kOrderHandCardsByCardId) {
+					// zone position is not maintained; the order is given by card id
+					return Key(kTagSelfHandCard, (int)card.GetCardId(), card.GetCost(), card.GetAttack(), card.GetHP());
+				}
+				else {
+					return Key(kTagSelfHandCard, (int)card.GetCardId(), card.GetCost(), card.GetAttack(), card.GetHP(),
+						card.GetZonePosition());
+				}
+
+			case kCardZonePlay:
+				switch (card.GetCardType()) {
+				case kCardTypeHero:
+					return Key(kTagHero, is_self, card.GetAttack(), card.GetHP(), card.GetMaxHP(), card.GetArmor());
+				case kCardTypeHeroPower:
+					return Key(kTagHeroPower, is_self, (int)card.GetCardId(), card.GetRawData().usable);
+				case kCardTypeWeapon:
+					return Key(kTagWeapon, is_self, (int)card.GetCardId(), card.GetAttack(), card.GetHP());
+				case kCardTypeMinion:
+					return Key(kTagMinion, is_self, card.GetZonePosition(),
+						(int)card.GetCardId(), card.GetAttack(), card.GetHP(), card.GetMaxHP());
+				default:
+					return 0;
+				}
+
+			default:
+				return 0;
+			}
+		}
+	};
+}
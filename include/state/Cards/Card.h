@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include "Cards/CardDispatcher.h"
@@ -41,6 +43,8 @@ namespace state
 		class Manager;
 		class Card
 		{
+			friend Manager;
+
 		public:
 			class ZoneSetter {
 			public:
@@ -83,12 +87,14 @@ namespace state
 			};
 
 		public:
-			Card() : data_() {}
-			explicit Card(const CardData & data) : data_(data) {}
-			explicit Card(CardData&& data) : data_(std::move(data)) {}
+			Card() : data_(), hash_contributions_(), hash_dirty_(false) {}
+			explicit Card(const CardData & data) : data_(data), hash_contributions_(), hash_dirty_(false) {}
+			explicit Card(CardData&& data) : data_(std::move(data)), hash_contributions_(), hash_dirty_(false) {}
 
 			void FillWithBase(Card const& base) {
 				data_.FillWithBase(base.data_);
+				hash_contributions_ = base.hash_contributions_;
+				hash_dirty_ = base.hash_dirty_;
 			}
 
 			void RestoreToDefault() {
@@ -201,6 +207,11 @@ namespace state
 
 		private:
 			CardData data_;
+
+			// Maintained by Manager: the contribution of this card to the board
+			// hash of each viewer, as of the last time the hash was flushed
+			std::array<std::uint64_t, 2> hash_contributions_;
+			bool hash_dirty_;
 		};
 	}
 }
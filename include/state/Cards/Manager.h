@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "Utils/CloneableContainers/Vector.h"
 #include "Utils/NeverShrinkVector.h"
 #include "state/Cards/Card.h"
+#include "state/BoardHash.h"
 #include "state/Types.h"
 
 namespace state
@@ -20,23 +24,41 @@ namespace state
 			// A customized vector is used to ensure the underlying buffer only grows, never shrinks
 			typedef Utils::CloneableContainers::Vector<ItemType, Utils::NeverShrinkVector<ItemType>> ContainerType;
 
-			Manager() : base_(nullptr), cards_() {}
+			Manager() : base_(nullptr), cards_(), written_cards_(), view_hash_(), dirty_cards_() {}
 
 			Manager(Manager const& rhs) :
-				base_(rhs.base_), cards_(rhs.cards_)
+				base_(rhs.base_), cards_(rhs.cards_), written_cards_(rhs.written_cards_),
+				view_hash_(rhs.view_hash_), dirty_cards_(rhs.dirty_cards_)
 			{}
 
+			// Only the cards written are copied. The others are read through the
+			// base, which might have its own base.
+			// If filled with the same base again (e.g., the probes of a DFS), only
+			// the cards written since then are discarded. The cost is proportional
+			// to the cards touched, not to all cards.
 			void FillWithBase(Manager const& base) {
-				assert(base.base_ == nullptr);
-				base_ = &base;
-
-				cards_.Reset();
+				if (base_ == &base) {
+					for (CardRef ref : written_cards_) cards_.Get(ref.id).UnSet();
+				}
+				else {
+					base_ = &base;
+					cards_.Reset();
+				}
+				written_cards_.clear();
 				cards_.Resize(base.cards_.Size());
+
+				// The dirty flags are copied along with the cards (on write),
+				// so the dirty list should be copied as well
+				view_hash_ = base.view_hash_;
+				dirty_cards_ = base.dirty_cards_;
 			}
 
 			Manager & operator=(Manager const& rhs) {
 				base_ = rhs.base_;
 				cards_ = rhs.cards_;
+				written_cards_ = rhs.written_cards_;
+				view_hash_ = rhs.view_hash_;
+				dirty_cards_ = rhs.dirty_cards_;
 				return *this;
 			}
 
@@ -50,29 +72,75 @@ namespace state
 			}
 
 			Card & GetMutable(CardRef id) {
-				auto & item = cards_.Get(id.id);
-				if (item.HasSet()) return item.Get();
-
-				assert(base_);
-				assert(id.id < (int)base_->cards_.Size());
-				item.SetWithBase(base_->Get(id)); // copy-on-write
-				return item.Get();
+				Card & card = GetMutableWithoutMarkDirty(id);
+				if (!card.hash_dirty_) {
+					card.hash_dirty_ = true;
+					dirty_cards_.push_back(id);
+				}
+				return card;
 			}
 
 			CardRef PushBack(Cards::Card && card)
 			{
 				assert(card.GetZone() == kCardZoneNewlyCreated);
-				return CardRef(cards_.PushBack(std::move(card)));
+				// a newly-created card is not observable, and contributes nothing
+				card.hash_contributions_.fill(0);
+				card.hash_dirty_ = false;
+				CardRef ref(cards_.PushBack(std::move(card)));
+				if (base_) written_cards_.push_back(ref);
+				return ref;
+			}
+
+			// Sum of the contributions of all cards to the board hash
+			// Only the cards changed since the last call are re-hashed
+			std::uint64_t GetViewHash(PlayerSide viewer) {
+				if (!dirty_cards_.empty()) FlushViewHash();
+				return view_hash_[BoardHash::GetViewerIndex(viewer)];
 			}
 
+			size_t Size() const { return cards_.Size(); }
+
 			void SetCardZonePos(CardRef ref, int pos)
 			{
 				GetMutable(ref).SetZonePos()(pos);
 			}
 
+		private:
+			Card & GetMutableWithoutMarkDirty(CardRef id) {
+				auto & item = cards_.Get(id.id);
+				if (item.HasSet()) return item.Get();
+
+				assert(base_);
+				assert(id.id < (int)base_->cards_.Size());
+				item.SetWithBase(base_->Get(id)); // copy-on-write
+				written_cards_.push_back(id);
+				return item.Get();
+			}
+
+			void FlushViewHash() {
+				for (CardRef ref : dirty_cards_) {
+					Card & card = GetMutableWithoutMarkDirty(ref);
+					assert(card.hash_dirty_);
+					for (PlayerSide viewer : { kPlayerFirst, kPlayerSecond }) {
+						int idx = BoardHash::GetViewerIndex(viewer);
+						std::uint64_t contribution = BoardHash::GetCardContribution(card, viewer);
+						view_hash_[idx] += contribution - card.hash_contributions_[idx];
+						card.hash_contributions_[idx] = contribution;
+					}
+					card.hash_dirty_ = false;
+				}
+				dirty_cards_.clear();
+			}
+
 		private:
 			Manager const* base_;
 			ContainerType cards_;
+
+			// The cards set over the base, since the last FillWithBase()
+			std::vector<CardRef> written_cards_;
+
+			std::array<std::uint64_t, 2> view_hash_;
+			std::vector<CardRef> dirty_cards_;
 		};
 	}
 }
\ No newline at end of file
@@ -7,4 +7,8 @@ namespace state
 	// --> https://hearthstone.gamepedia.com/Simulacrum
 	// The good side is to reduce the useless branch factor in the game tree
 	static constexpr bool kOrderHandCardsByCardId = true;
+
+	// Recompute the board hash from scratch on every query, and check it against
+	// the incrementally-maintained one. This is slow; only for debugging.
+	static constexpr bool kCrossCheckViewHash = false;
 }
\ No newline at end of file
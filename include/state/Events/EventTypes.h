@@ -1,8 +1,8 @@
 
 #include <tuple>
 #include <string>
-#include <functional>
 #include "state/Types.h"
+#include "Utils/InlineFunction.h"
 
 namespace FlowControl { class Manipulate; }
 namespace state {
@@ -17,21 +17,21 @@ namespace state {
 					int * cost_;
 					bool * cost_health_instead_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct AfterMinionPlayed {
 				struct Context {
 					FlowControl::Manipulate const& manipulate_;
 					CardRef card_ref_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct AfterMinionSummoned {
 				struct Context {
 					FlowControl::Manipulate const& manipulate_;
 					CardRef card_ref_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct AfterMinionDied {
 				struct Context {
@@ -39,7 +39,7 @@ namespace state {
 					CardRef card_ref_;
 					state::PlayerIdentifier died_minion_owner_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct BeforeMinionSummoned {
 				struct Context {
@@ -55,7 +55,7 @@ namespace state {
 					state::CardRef attacker_;
 					state::CardRef * defender_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct BeforeAttack {
 				struct Context {
@@ -63,7 +63,7 @@ namespace state {
 					state::CardRef attacker_;
 					state::CardRef defender_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct AfterAttack {
 				struct Context {
@@ -71,7 +71,7 @@ namespace state {
 					state::CardRef attacker_;
 					state::CardRef defender_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			
 			struct PreparePlayCardTarget {
@@ -80,14 +80,14 @@ namespace state {
 					state::CardRef card_ref_;
 					state::CardRef * target_ref_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct OnPlay {
 				struct Context {
 					FlowControl::Manipulate const& manipulate_;
 					state::CardRef card_ref_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct CheckPlayCardCountered {
 				struct Context {
@@ -95,7 +95,7 @@ namespace state {
 					state::CardRef card_ref_;
 					bool * countered_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 
 			struct CalculateHealDamageAmount {
@@ -104,7 +104,7 @@ namespace state {
 					state::CardRef const source_ref_;
 					int * amount_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct PrepareHealDamageTarget {
 				struct Context {
@@ -112,7 +112,7 @@ namespace state {
 					state::CardRef const source_ref_;
 					state::CardRef * target_ref_; // an invalid target means the damage event is cancelled
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 
 			struct OnTakeDamage {
@@ -121,7 +121,7 @@ namespace state {
 					state::CardRef card_ref_;
 					int * damage_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct CategorizedOnTakeDamage {
 				struct Context {
@@ -137,7 +137,7 @@ namespace state {
 					int damage_;
 					int damage_after_armor_absorbed_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 
 			struct AfterHeroPower { // a.k.a. inspire
@@ -154,7 +154,7 @@ namespace state {
 					state::PlayerIdentifier player_;
 					state::CardRef const card_ref_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 
 			struct AfterSecretPlayed {
@@ -163,7 +163,7 @@ namespace state {
 					state::PlayerIdentifier player_;
 					state::CardRef const card_ref_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 
 			struct OnHeal {
@@ -172,19 +172,19 @@ namespace state {
 					state::CardRef card_ref_;
 					int amount_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct OnTurnEnd {
 				struct Context {
 					FlowControl::Manipulate const& manipulate_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 			struct OnTurnStart {
 				struct Context {
 					FlowControl::Manipulate const& manipulate_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 
 			struct BeforeSecretReveal {
@@ -192,7 +192,7 @@ namespace state {
 					FlowControl::Manipulate const& manipulate_;
 					state::CardRef card_ref_;
 				};
-				using type = std::function<bool(Context const&)>;
+				using type = Utils::InlineFunction<bool(Context const&)>;
 			};
 		}
 	}
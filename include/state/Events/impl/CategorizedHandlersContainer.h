@@ -34,14 +34,15 @@ namespace state
 					return *this;
 				}
 
+				// The base might have its own base. Its content is the one we read through.
 				void FillWithBase(CategorizedHandlersContainer<TriggerType> const& base) {
-					assert(base.base_ == nullptr);
-					base_ = &base.handlers_;
+					base_ = &base.GetContainerForRead();
 				}
 
 				// Cloneable by copy semantics
 				//    Since the STL container and HandlersContainer are with this property
 				static const bool CloneableByCopySemantics = true;
+				static_assert(std::is_trivially_copyable_v<Item>, "Handlers should be trivially copyable");
 
 				template <typename HandlerType_>
 				void PushBack(CardRef card_ref, HandlerType_&& handler)
@@ -115,7 +116,7 @@ namespace state
 			private:
 				using container_type = std::vector<Item>;
 
-				container_type const& GetContainerForRead() {
+				container_type const& GetContainerForRead() const {
 					if (base_) return *base_;
 					return handlers_;
 				}
@@ -26,14 +26,16 @@ namespace state
 					return *this;
 				}
 
+				// The base might have its own base. Its content is the one we read through.
 				void FillWithBase(HandlersContainer<TriggerType> const& base) {
-					assert(base.base_ == nullptr);
-					base_ = &base.handlers_;
+					base_ = &base.GetContainerForRead();
 				}
 
 				// Cloneable by copy semantics
 				//    Since the STL container and the underlying HandlerType are with this property
+				//    The handlers are trivially copyable, so the vector is copied by memcpy
 				static const bool CloneableByCopySemantics = true;
+				static_assert(std::is_trivially_copyable_v<typename TriggerType::type>, "Handlers should be trivially copyable");
 
 				template <typename T>
 				void PushBack(T&& handler)
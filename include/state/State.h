@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include "state/Types.h"
+#include "state/BoardHash.h"
+#include "state/Configs.h"
 #include "state/aura/Manager.h"
 #include "state/board/Board.h"
 #include "state/Cards/Manager.h"
@@ -25,12 +28,18 @@ namespace state
 			current_player_(), turn_(0), play_order_(1)
 		{}
 
+		// Fork from a base state. Only the parts written afterwards are copied
+		// (copy-on-write); the others are read through the base.
+		// The base might be forked from another base as well, so the layers can
+		// be stacked (e.g., the root state, an MCTS iteration, a DFS probe).
+		// The base (and its bases) should outlive this state, and should not be
+		// modified before this state is discarded or re-filled.
 		void FillWithBase(State const& base)
 		{
 			board_.FillWithBase(base.board_);
 			cards_mgr_.FillWithBase(base.cards_mgr_);
 			event_mgr_.FillWithBase(base.event_mgr_);
-			aura_mgr_ = base.aura_mgr_;
+			aura_mgr_.FillWithBase(base.aura_mgr_);
 			current_player_ = base.current_player_;
 			turn_ = base.turn_;
 			play_order_ = base.play_order_;
@@ -103,6 +112,52 @@ namespace state
 			});
 		}
 
+	public: // board hash
+		// Hash of the board observed by 'viewer' (see BoardHash)
+		// The cards are re-hashed only if changed since the last call; the
+		// resources, deck sizes, and turn are hashed here in constant time
+		std::uint64_t GetViewHash(PlayerSide viewer) {
+			std::uint64_t hash = cards_mgr_.GetViewHash(viewer) + GetNonCardViewHash(viewer);
+			if constexpr (kCrossCheckViewHash) {
+				assert(hash == ComputeViewHash(viewer));
+			}
+			return hash;
+		}
+
+		// Compute the board hash from scratch
+		std::uint64_t ComputeViewHash(PlayerSide viewer) const {
+			std::uint64_t hash = GetNonCardViewHash(viewer);
+			auto add_card = [&](CardRef ref) {
+				if (ref.IsValid()) hash += BoardHash::GetCardContribution(GetCard(ref), viewer);
+				return true;
+			};
+			for (PlayerSide side : { kPlayerFirst, kPlayerSecond }) {
+				board::Player const& player = board_.Get(side);
+				add_card(player.GetHeroRef());
+				add_card(player.GetHeroPowerRef());
+				add_card(player.GetWeaponRef());
+				player.minions_.ForEach(add_card);
+				player.hand_.ForEach(add_card);
+			}
+			return hash;
+		}
+
+	private:
+		std::uint64_t GetNonCardViewHash(PlayerSide viewer) const {
+			std::uint64_t hash = BoardHash::Key(BoardHash::kTagTurn, turn_) +
+				BoardHash::Key(BoardHash::kTagViewer, (int)viewer);
+			for (PlayerSide side : { kPlayerFirst, kPlayerSecond }) {
+				board::Player const& player = board_.Get(side);
+				board::PlayerResource const& resource = player.GetResource();
+				bool is_self = (side == viewer);
+				hash += BoardHash::Key(BoardHash::kTagResource, is_self,
+					resource.GetCurrent(), resource.GetTotal(),
+					resource.GetCurrentOverloaded(), resource.GetNextOverload());
+				hash += BoardHash::Key(BoardHash::kTagDeck, is_self, player.deck_.Size());
+			}
+			return hash;
+		}
+
 	public: // bridge to event manager
 		template <typename EventType, typename T>
 		void AddEvent(T&& handler) {
@@ -9,17 +9,33 @@ namespace state {
 		class Manager
 		{
 		public:
-			Manager() : auras_() {}
+			Manager() : base_(nullptr), auras_() {}
+
+			Manager(Manager const& rhs) : base_(rhs.base_), auras_(rhs.auras_) {}
+			Manager & operator=(Manager const& rhs) {
+				base_ = rhs.base_;
+				auras_ = rhs.auras_;
+				return *this;
+			}
+
+			// The base might have its own base. Its content is the one we read through.
+			void FillWithBase(Manager const& base) {
+				base_ = &base.GetContainerForRead();
+			}
 
 			void Add(FlowControl::aura::Handler handler) {
-				auras_.push_back(std::move(handler));
+				GetContainerForWrite().push_back(std::move(handler));
 			}
 
 			template <typename Functor> // Functor = bool(FlowControl::aura::Handler &). returns false to remove it from container
 			void ForEachAura(Functor&& functor) {
-				for (auto it = auras_.begin(); it != auras_.end();) {
+				// The handlers keep their update states, so they are always written
+				if (GetContainerForRead().empty()) return;
+
+				auto & auras = GetContainerForWrite();
+				for (auto it = auras.begin(); it != auras.end();) {
 					if (!functor(*it)) {
-						it = auras_.erase(it);
+						it = auras.erase(it);
 					}
 					else {
 						++it;
@@ -28,7 +44,24 @@ namespace state {
 			}
 
 		private:
-			std::vector<FlowControl::aura::Handler> auras_;
+			using ContainerType = std::vector<FlowControl::aura::Handler>;
+
+			ContainerType const& GetContainerForRead() const {
+				if (base_) return *base_;
+				return auras_;
+			}
+
+			ContainerType & GetContainerForWrite() {
+				if (base_) {
+					auras_ = *base_; // copy-on-write
+					base_ = nullptr;
+				}
+				return auras_;
+			}
+
+		private:
+			ContainerType const* base_;
+			ContainerType auras_;
 		};
 	}
-}
\ No newline at end of file
+}
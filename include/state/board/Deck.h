@@ -17,8 +17,10 @@ namespace state
 		{
 			template <CardType TargetCardType, CardZone TargetCardZone> friend struct state::detail::PlayerDataStructureMaintainer;
 			
-		private:
+		public:
 			constexpr static int max_size = 80;
+
+		private:
 			using CardsContainer = std::array< ::Cards::CardId, max_size>;
 
 		public:
@@ -32,11 +34,9 @@ namespace state
 			{}
 
 			void FillWithBase(Deck const& base) {
-				assert(base.base_cards_ == nullptr);
-
 				change_id_ = base.change_id_;
 				size_ = base.size_;
-				base_cards_ = &base.cards_;
+				base_cards_ = &base.GetCards(); // the base might have its own base
 			}
 
 			int Size() const { return size_; }
@@ -27,8 +27,7 @@ namespace state
 				}
 
 				void FillWithBase(ContainerType const& base) {
-					assert(base.base_ == nullptr);
-					base_ = &base.items_;
+					base_ = &base.GetContainerForRead(); // the base might have its own base
 				}
 
 				template <class... Args>
@@ -15,6 +15,8 @@ namespace state
 			template <CardType TargetCardType, CardZone TargetCardZone> friend struct state::detail::PlayerDataStructureMaintainer;
 
 		public:
+			static constexpr int max_size_ = 7;
+
 			Minions() : minions_(), change_id_(0)
 			{
 				minions_.reserve(max_size_);
@@ -82,7 +84,6 @@ namespace state
 			}
 
 		private:
-			static constexpr int max_size_ = 7;
 			std::vector<CardRef> minions_; // TODO: use std::array?
 			int change_id_;
 		};
@@ -27,8 +27,7 @@ namespace state
 			}
 
 			void FillWithBase(Secrets const& base) {
-				assert(base.base_ == nullptr);
-				base_ = &base.secrets_;
+				base_ = &base.GetContainer(); // the base might have its own base
 			}
 
 			bool Exists(::Cards::CardId card_id) const
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ostream>
+
+namespace benchmark
+{
+	// Micro-benchmarks, each reports its result to the stream
+	void ChildNodeMap(std::ostream & s);
+	void EdgeAddon(std::ostream & s);
+	void NeuralNetworkInference(std::ostream & s);
+
+	// Reads cards.json in the working directory
+	void BoardFingerprint(std::ostream & s);
+	void StateClone(std::ostream & s);
+	void NeuralNetworkFeatures(std::ostream & s);
+
+	// Reads simulation_net in the working directory
+	void NeuralNetworkBatch(std::ostream & s);
+}
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <iostream>
+
+#include "FlowControl/FlowController-impl.h"
+#include "MCTS/TestStateBuilder.h"
+#include "MCTS/board/BoardView-impl.h"
+#include "MCTS/detail/BoardNodeMap-impl.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	void AddMinion(Cards::CardId id, state::State & state, state::PlayerIdentifier player)
+	{
+		state::Cards::CardData raw_card = Cards::CardDispatcher::CreateInstance(id);
+		raw_card.enchanted_states.player = player;
+		raw_card.enchantment_handler.SetOriginalStates(raw_card.enchanted_states);
+		raw_card.zone = state::kCardZoneNewlyCreated;
+
+		int pos = (int)state.GetBoard().Get(player).minions_.Size();
+		auto ref = state.AddCard(state::Cards::Card(raw_card));
+		state.GetZoneChanger<state::kCardTypeMinion, state::kCardZoneNewlyCreated>(ref)
+			.ChangeTo<state::kCardZonePlay>(player, pos);
+	}
+
+	// A mid-game board: a few minions on each side
+	state::State GetBoard()
+	{
+		state::State state = TestStateBuilder().GetState(0);
+		for (int i = 0; i < 3; ++i) {
+			AddMinion(Cards::ID_CS2_120, state, state::PlayerIdentifier::First());
+			AddMinion(Cards::ID_CS2_172, state, state::PlayerIdentifier::Second());
+		}
+		return state;
+	}
+
+	// Mimic an action: the attack of a minion on each side is changed
+	void ChangeCards(state::State & state, int round)
+	{
+		for (state::PlayerIdentifier player : { state::PlayerIdentifier::First(), state::PlayerIdentifier::Second() }) {
+			state::CardRef ref = state.GetBoard().Get(player).minions_.Get(0);
+			state.GetMutableCard(ref).SetAttack(3 + (round & 1));
+		}
+	}
+
+	template <class Functor>
+	double Measure(int rounds, Functor && functor)
+	{
+		std::uint64_t checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < rounds; ++i) {
+			checksum += functor(i);
+		}
+		auto end = std::chrono::steady_clock::now();
+		if (checksum == 1) std::cout << ""; // keep the loop
+
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		return ns / rounds;
+	}
+}
+
+namespace benchmark
+{
+	void BoardFingerprint(std::ostream & s)
+	{
+		if (!Cards::Database::GetInstance().Initialize("cards.json")) {
+			s << "Failed to read cards.json" << std::endl;
+			return;
+		}
+
+		Utils::Arena arena;
+		Utils::Arena::ThreadScope arena_scope(arena);
+
+		constexpr int kRounds = 1 << 18;
+
+		state::State state = GetBoard();
+		mcts::board::Board board(state, state::kPlayerFirst);
+
+		mcts::detail::BoardNodeMap map;
+		map.GetOrCreateNode(board);
+
+		s << "board view + std::hash (ns): " << Measure(kRounds, [&](int) {
+			return (std::uint64_t)std::hash<mcts::board::BoardView>()(board.CreateView());
+		}) << std::endl;
+
+		s << "full recompute of board hash (ns): " << Measure(kRounds, [&](int) {
+			return state.ComputeViewHash(state::kPlayerFirst);
+		}) << std::endl;
+
+		s << "incremental fingerprint (ns): " << Measure(kRounds, [&](int) {
+			return board.GetFingerprint();
+		}) << std::endl;
+
+		s << "change 2 cards + board view + std::hash (ns): " << Measure(kRounds, [&](int i) {
+			ChangeCards(state, i);
+			return (std::uint64_t)std::hash<mcts::board::BoardView>()(board.CreateView());
+		}) << std::endl;
+
+		s << "change 2 cards + incremental fingerprint (ns): " << Measure(kRounds, [&](int i) {
+			ChangeCards(state, i);
+			return board.GetFingerprint();
+		}) << std::endl;
+
+		s << "change 2 cards + BoardNodeMap::GetOrCreateNode (ns): " << Measure(kRounds, [&](int i) {
+			ChangeCards(state, i);
+			return (std::uint64_t)map.GetOrCreateNode(board);
+		}) << std::endl;
+	}
+}
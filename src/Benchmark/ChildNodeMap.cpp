@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "MCTS/selection/ChildNodeMap.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	using mcts::selection::ChildType;
+	using mcts::selection::EdgeAddon;
+
+	// The node-based hash map used before the child table
+	class LegacyChildNodeMap
+	{
+	public:
+		LegacyChildNodeMap() : map_() {}
+
+		ChildType const* Get(int choice) const {
+			auto it = map_.find(choice);
+			if (it == map_.end()) return nullptr;
+			return &(it->second);
+		}
+
+		ChildType* GetOrCreateRedirectNode(int choice) {
+			ChildType & child = map_[choice];
+			child.SetAsRedirectNode();
+			return &child;
+		}
+
+	private:
+		std::unordered_map<int, ChildType> map_;
+	};
+
+	// Mimic UCBPolicy::SelectChoice: look up every choice, then score them
+	template <class MapType>
+	int SelectChoice(MapType const& map, std::vector<int> const& choices)
+	{
+		std::int64_t total_chosen_times = 0;
+		for (int choice : choices) {
+			ChildType const* child = map.Get(choice);
+			if (!child) continue;
+			total_chosen_times += child->GetEdgeAddon().GetChosenTimes();
+		}
+
+		int best_choice = -1;
+		double best_score = -1.0;
+		for (int choice : choices) {
+			ChildType const* child = map.Get(choice);
+			if (!child) continue;
+			EdgeAddon const& addon = child->GetEdgeAddon();
+			double score = (double)addon.GetCredit() / addon.GetTotal() +
+				0.8 * std::sqrt(std::log((double)total_chosen_times) / addon.GetChosenTimes());
+			if (score > best_score) {
+				best_score = score;
+				best_choice = choice;
+			}
+		}
+		return best_choice;
+	}
+
+	template <class MapType>
+	double MeasureSelections(int nodes, int children, int selections, std::mt19937 & rand)
+	{
+		std::vector<std::unique_ptr<MapType>> maps;
+		std::vector<int> choices;
+		for (int i = 0; i < children; ++i) {
+			choices.push_back(i < 8 ? i : (int)(rand() % 1000) + 8); // card ids for choose-one
+		}
+
+		for (int i = 0; i < nodes; ++i) {
+			maps.push_back(std::make_unique<MapType>());
+			for (int choice : choices) {
+				EdgeAddon & addon = maps.back()->GetOrCreateRedirectNode(choice)->GetEdgeAddon();
+				addon.AddChosenTimes(1 + rand() % 100);
+				addon.AddTotal(100);
+				addon.AddCredit(rand() % 100);
+			}
+		}
+
+		std::vector<int> order;
+		for (int i = 0; i < selections; ++i) order.push_back(rand() % nodes);
+
+		int checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int idx : order) {
+			checksum += SelectChoice(*maps[idx], choices);
+		}
+		auto end = std::chrono::steady_clock::now();
+		if (checksum == -1) std::cout << ""; // keep the loop
+
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		return ns / selections;
+	}
+}
+
+namespace benchmark
+{
+	void ChildNodeMap(std::ostream & s)
+	{
+		Utils::Arena arena;
+		Utils::Arena::ThreadScope arena_scope(arena);
+
+		constexpr int kNodes = 1 << 14;
+		constexpr int kSelections = 1 << 21;
+
+		std::mt19937 rand(0);
+		s << "children\tunordered_map(ns)\tchild table(ns)" << std::endl;
+		for (int children : { 2, 4, 8, 16, 32 }) {
+			double legacy = MeasureSelections<LegacyChildNodeMap>(kNodes, children, kSelections, rand);
+			double current = MeasureSelections<mcts::selection::ChildNodeMap>(kNodes, children, kSelections, rand);
+			s << children << "\t" << legacy << "\t" << current << std::endl;
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "MCTS/selection/ChildNodeMap.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	// The statistics used before the packed counters
+	class LegacyEdgeAddon
+	{
+	public:
+		LegacyEdgeAddon() : chosen_times(0), credit(0), total(0) {}
+
+		void AddChosenTimes(int v) { chosen_times += v; }
+		void AddTotal(int v) { total += v; }
+		void AddCredit(int v) { credit += v; }
+
+		void AddCreditAndTotal(int credit, int total) {
+			AddTotal(total);
+			AddCredit(credit);
+		}
+
+		auto GetTotal() const { return total.load(); }
+
+	private:
+		std::atomic<std::int64_t> chosen_times;
+		std::atomic<std::int64_t> credit;
+		std::atomic<std::int64_t> total;
+	};
+
+	// The legacy child entry: edge statistics, type, and node pointer
+	struct LegacyChildType {
+		LegacyEdgeAddon edge_addon;
+		std::atomic<int> type;
+		std::atomic<void *> node;
+	};
+
+	constexpr int kVirtualLoss = 3;
+
+	// Mimic TreeUpdater: add virtual loss when the path is selected, then
+	// update the chosen times and remove the virtual loss, then the win rate
+	template <class AddonType>
+	double MeasureBackprop(int edges, int path_length, int paths, std::mt19937 & rand)
+	{
+		std::unique_ptr<AddonType[]> addons(new AddonType[edges]);
+
+		std::vector<int> order;
+		for (int i = 0; i < paths * path_length; ++i) order.push_back(rand() % edges);
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < order.size(); i += path_length) {
+			for (int j = 0; j < path_length; ++j) {
+				addons[order[i + j]].AddTotal(kVirtualLoss);
+			}
+			for (int j = 0; j < path_length; ++j) {
+				auto & addon = addons[order[i + j]];
+				addon.AddChosenTimes(1);
+				addon.AddTotal(-kVirtualLoss);
+			}
+			for (int j = 0; j < path_length; ++j) {
+				addons[order[i + j]].AddCreditAndTotal(50, 100);
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		if (addons[0].GetTotal() == -1) std::cout << ""; // keep the loop
+
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		return ns / order.size();
+	}
+}
+
+namespace benchmark
+{
+	void EdgeAddon(std::ostream & s)
+	{
+		using mcts::selection::ChildType;
+
+		s << "bytes per edge: EdgeAddon " << sizeof(LegacyEdgeAddon)
+			<< " -> " << sizeof(mcts::selection::EdgeAddon)
+			<< ", ChildType " << sizeof(LegacyChildType)
+			<< " -> " << sizeof(ChildType) << std::endl;
+
+		constexpr int kPathLength = 20;
+		constexpr int kPaths = 1 << 16;
+
+		std::mt19937 rand(0);
+		s << "edges\tlegacy backprop(ns/edge)\tpacked backprop(ns/edge)" << std::endl;
+		for (int edges : { 1 << 10, 1 << 20 }) {
+			double legacy = MeasureBackprop<LegacyEdgeAddon>(edges, kPathLength, kPaths, rand);
+			double current = MeasureBackprop<mcts::selection::EdgeAddon>(edges, kPathLength, kPaths, rand);
+			s << edges << "\t" << legacy << "\t" << current << std::endl;
+		}
+	}
+}
@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "FlowControl/FlowController-impl.h"
+#include "MCTS/TestStateBuilder.h"
+#include "NeuralNetworkInput.h"
+#include "NeuralNetworkStateEncoder.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	// The previous path, as it was in MCTS/policy/Simulation.h and
+	// NeuralNetwork.cpp: the network pulls every field through a virtual call,
+	// and the fields are pushed to the tiny-dnn input vectors
+	// The bridge flags an opponent minion by the index of an attacker of the
+	// current player; none can attack in the measured state.
+	class StateDataBridge : public NeuralNetworkWrapper::IInputGetter
+	{
+	public:
+		StateDataBridge() : state_(nullptr), attackable_indics_(),
+			playable_cards_(), hero_power_playable_()
+		{}
+
+		StateDataBridge(StateDataBridge const&) = delete;
+		StateDataBridge & operator=(StateDataBridge const&) = delete;
+
+		void Reset(state::State const& state) {
+			state_ = &state;
+
+			FlowControl::ValidActionGetter valid_action(*state_);
+
+			attackable_indics_.clear();
+			valid_action.ForEachAttacker([this](int encoded_idx) {
+				attackable_indics_.push_back(encoded_idx);
+				return true;
+			});
+
+			playable_cards_.clear();
+			valid_action.ForEachPlayableCard([&](size_t idx) {
+				playable_cards_.push_back((int)idx);
+				return true;
+			});
+
+			hero_power_playable_ = valid_action.CanUseHeroPower();
+		}
+
+		double GetField(
+			NeuralNetworkWrapper::FieldSide field_side,
+			NeuralNetworkWrapper::FieldType field_type,
+			int arg1 = 0) override final
+		{
+			if (field_side == NeuralNetworkWrapper::kCurrent) {
+				return GetSideField(field_type, arg1, state_->GetCurrentPlayer());
+			}
+			else if (field_side == NeuralNetworkWrapper::kOpponent) {
+				return GetSideField(field_type, arg1, state_->GetOppositePlayer());
+			}
+			throw std::runtime_error("invalid side");
+		}
+
+	private:
+		double GetSideField(NeuralNetworkWrapper::FieldType field_type, int arg1, state::board::Player const& player) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kResourceCurrent:
+			case NeuralNetworkWrapper::kResourceTotal:
+			case NeuralNetworkWrapper::kResourceOverload:
+			case NeuralNetworkWrapper::kResourceOverloadNext:
+				return GetResourceField(field_type, arg1, player.GetResource());
+
+			case NeuralNetworkWrapper::kHeroHP:
+			case NeuralNetworkWrapper::kHeroArmor:
+				return GetHeroField(field_type, arg1, state_->GetCard(player.GetHeroRef()));
+
+			case NeuralNetworkWrapper::kMinionCount:
+			case NeuralNetworkWrapper::kMinionHP:
+			case NeuralNetworkWrapper::kMinionMaxHP:
+			case NeuralNetworkWrapper::kMinionAttack:
+			case NeuralNetworkWrapper::kMinionAttackable:
+			case NeuralNetworkWrapper::kMinionTaunt:
+			case NeuralNetworkWrapper::kMinionShield:
+			case NeuralNetworkWrapper::kMinionStealth:
+				return GetMinionsField(field_type, arg1, player.minions_);
+
+			case NeuralNetworkWrapper::kHandCount:
+			case NeuralNetworkWrapper::kHandPlayable:
+			case NeuralNetworkWrapper::kHandCost:
+				return GetHandField(field_type, arg1, player.hand_);
+
+			case NeuralNetworkWrapper::kHeroPowerPlayable:
+				return GetHeroPowerField(field_type, arg1);
+
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+		double GetResourceField(NeuralNetworkWrapper::FieldType field_type, int arg1, state::board::PlayerResource const& resource) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kResourceCurrent:
+				return resource.GetCurrent();
+			case NeuralNetworkWrapper::kResourceTotal:
+				return resource.GetTotal();
+			case NeuralNetworkWrapper::kResourceOverload:
+				return resource.GetCurrentOverloaded();
+			case NeuralNetworkWrapper::kResourceOverloadNext:
+				return resource.GetNextOverload();
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+		double GetHeroField(NeuralNetworkWrapper::FieldType field_type, int arg1, state::Cards::Card const& hero) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kHeroHP:
+				return hero.GetHP();
+			case NeuralNetworkWrapper::kHeroArmor:
+				return hero.GetArmor();
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+		double GetMinionsField(NeuralNetworkWrapper::FieldType field_type, int minion_idx, state::board::Minions const& minions) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kMinionCount:
+				return (double)minions.Size();
+			case NeuralNetworkWrapper::kMinionHP:
+			case NeuralNetworkWrapper::kMinionMaxHP:
+			case NeuralNetworkWrapper::kMinionAttack:
+			case NeuralNetworkWrapper::kMinionAttackable:
+			case NeuralNetworkWrapper::kMinionTaunt:
+			case NeuralNetworkWrapper::kMinionShield:
+			case NeuralNetworkWrapper::kMinionStealth:
+				return GetMinionField(field_type, minion_idx, state_->GetCard(minions.Get(minion_idx)));
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+		double GetMinionField(NeuralNetworkWrapper::FieldType field_type, int minion_idx, state::Cards::Card const& minion) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kMinionHP:
+				return minion.GetHP();
+			case NeuralNetworkWrapper::kMinionMaxHP:
+				return minion.GetMaxHP();
+			case NeuralNetworkWrapper::kMinionAttack:
+				return minion.GetAttack();
+			case NeuralNetworkWrapper::kMinionAttackable:
+				return (std::find(attackable_indics_.begin(), attackable_indics_.end(), minion_idx) != attackable_indics_.end());
+			case NeuralNetworkWrapper::kMinionTaunt:
+				return minion.HasTaunt();
+			case NeuralNetworkWrapper::kMinionShield:
+				return minion.HasShield();
+			case NeuralNetworkWrapper::kMinionStealth:
+				return minion.HasStealth();
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+		double GetHandField(NeuralNetworkWrapper::FieldType field_type, int hand_idx, state::board::Hand const& hand) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kHandCount:
+				return (double)hand.Size();
+			case NeuralNetworkWrapper::kHandPlayable:
+			case NeuralNetworkWrapper::kHandCost:
+				return GetHandCardField(field_type, hand_idx, state_->GetCard(hand.Get(hand_idx)));
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+		double GetHandCardField(NeuralNetworkWrapper::FieldType field_type, int hand_idx, state::Cards::Card const& card) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kHandPlayable:
+				return (std::find(playable_cards_.begin(), playable_cards_.end(), hand_idx) != playable_cards_.end());
+			case NeuralNetworkWrapper::kHandCost:
+				return card.GetCost();
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+		double GetHeroPowerField(NeuralNetworkWrapper::FieldType field_type, int arg1) {
+			switch (field_type) {
+			case NeuralNetworkWrapper::kHeroPowerPlayable:
+				return hero_power_playable_;
+			default:
+				throw std::runtime_error("unknown field type");
+			}
+		}
+
+	private:
+		state::State const* state_;
+		std::vector<int> attackable_indics_;
+		std::vector<int> playable_cards_;
+		bool hero_power_playable_;
+	};
+
+	// tiny_dnn::vec_t aligns its buffers to 64 bytes
+	template <class T>
+	struct AlignedAllocator
+	{
+		using value_type = T;
+
+		AlignedAllocator() = default;
+		template <class U> AlignedAllocator(AlignedAllocator<U> const&) {}
+
+		T * allocate(size_t n) {
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64)));
+		}
+		void deallocate(T * p, size_t) {
+			::operator delete(p, std::align_val_t(64));
+		}
+
+		template <class U> bool operator==(AlignedAllocator<U> const&) const { return true; }
+		template <class U> bool operator!=(AlignedAllocator<U> const&) const { return false; }
+	};
+
+	using Vector = std::vector<float, AlignedAllocator<float>>;
+	using Tensor = std::vector<Vector>;
+
+	float NormalizeFromUniformDist(double v, double min, double max) {
+		// normalize to mean = 0, var = 1.0
+		// uniform dist is with variance = (max-min)^2 / 12
+		// --> so we should have (max-min)^2 / 12 = 1.0
+		// --> (max-min)^2 = 12.0
+		// --> (max-min) = sqrt(12.0)
+		static double sqrt_12 = std::sqrt(12.0);
+
+		double mean = (min + max) / 2;
+		double range = (max - min);
+		double scale = sqrt_12 / range;
+
+		double ret = (v - mean) * scale;
+		return (float)ret;
+	}
+
+	float NormalizeBool(bool v) {
+		double vv = 0.0;
+		if (v) vv = 1.0;
+		else vv = -1.0;
+		double ret = NormalizeFromUniformDist(vv, -1.0, 1.0);
+		return (float)ret;
+	}
+
+	void AddHeroData(
+		NeuralNetworkWrapper::FieldSide side,
+		NeuralNetworkWrapper::IInputGetter * getter,
+		Vector & data)
+	{
+		double hp = getter->GetField(side, NeuralNetworkWrapper::kHeroHP) +
+			getter->GetField(side, NeuralNetworkWrapper::kHeroArmor);
+		data.push_back(NormalizeFromUniformDist(hp, 0.0, 30.0));
+		//data.push_back(player["attack"].asFloat());
+		//data.push_back(player["attackable"].asBool());
+	}
+
+	void AddMinionData(
+		NeuralNetworkWrapper::FieldSide side,
+		NeuralNetworkWrapper::IInputGetter * getter,
+		int minion_idx,
+		Vector & data)
+	{
+		data.push_back(NormalizeFromUniformDist(getter->GetField(side, NeuralNetworkWrapper::kMinionHP, minion_idx), 1.0, 7.0));
+		data.push_back(NormalizeFromUniformDist(getter->GetField(side, NeuralNetworkWrapper::kMinionMaxHP, minion_idx), 1.0, 7.0));
+		data.push_back(NormalizeFromUniformDist(getter->GetField(side, NeuralNetworkWrapper::kMinionAttack, minion_idx), 0.0, 7.0));
+		data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionAttackable, minion_idx)));
+		data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionTaunt, minion_idx)));
+		data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionShield, minion_idx)));
+		data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionStealth, minion_idx)));
+	}
+
+	void AddMinionPlaceHolderData(Vector & data) {
+		data.push_back(0.0);
+		data.push_back(0.0);
+		data.push_back(0.0);
+		data.push_back(NormalizeBool(false));
+		data.push_back(NormalizeBool(false));
+		data.push_back(NormalizeBool(false));
+		data.push_back(NormalizeBool(false));
+	}
+
+	void AddMinionsData(
+		NeuralNetworkWrapper::FieldSide side,
+		NeuralNetworkWrapper::IInputGetter * getter,
+		Vector & data)
+	{
+		int rest = 7;
+		for (int i = 0; i < (int)getter->GetField(side, NeuralNetworkWrapper::kMinionCount); ++i) {
+			if (rest <= 0) throw std::runtime_error("too many minions");
+			AddMinionData(side, getter, i, data);
+			--rest;
+		}
+		while (rest > 0) {
+			AddMinionPlaceHolderData(data);
+			--rest;
+		}
+	}
+
+	void AddStandAloneData(
+		NeuralNetworkWrapper::IInputGetter * getter,
+		Vector & data)
+	{
+		data.push_back(NormalizeFromUniformDist(getter->GetField(
+			NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceCurrent), 0, 10));
+		data.push_back(NormalizeFromUniformDist(getter->GetField(
+			NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceTotal), 0, 10));
+		data.push_back(NormalizeFromUniformDist(getter->GetField(
+			NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceOverloadNext), 0, 10));
+
+		int cur_hand_count = (int)getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandCount);
+		data.push_back(NormalizeFromUniformDist(cur_hand_count, 0, 10));
+
+		int cur_hand_playable = 0;
+		for (int i = 0; i < cur_hand_count; ++i) {
+			bool playable = getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandPlayable, i);
+			if (playable) {
+				++cur_hand_playable;
+			}
+		}
+		data.push_back(NormalizeFromUniformDist(cur_hand_playable, 0, 10));
+
+		int hand_cards = 0;
+		for (int i = 0; i < cur_hand_count; ++i) {
+			data.push_back(NormalizeFromUniformDist(
+				getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandCost, i), 0, 10));
+			++hand_cards;
+		}
+		while (hand_cards < 10) {
+			data.push_back(NormalizeFromUniformDist(-1, 0, 10));
+			++hand_cards;
+		}
+
+		int opn_hand_count = (int)getter->GetField(NeuralNetworkWrapper::kOpponent, NeuralNetworkWrapper::kHandCount);
+		data.push_back(NormalizeFromUniformDist(opn_hand_count, 0, 10));
+
+		data.push_back(NormalizeBool(
+			getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHeroPowerPlayable)));
+	}
+
+	void GetInputData(NeuralNetworkWrapper::IInputGetter * getter, Tensor & data) {
+		Vector input1;
+		AddHeroData(NeuralNetworkWrapper::kCurrent, getter, input1);
+		AddHeroData(NeuralNetworkWrapper::kOpponent, getter, input1);
+		data.push_back(std::move(input1));
+
+		Vector input2;
+		AddMinionsData(NeuralNetworkWrapper::kCurrent, getter, input2);
+		AddMinionsData(NeuralNetworkWrapper::kOpponent, getter, input2);
+		data.push_back(std::move(input2));
+
+		Vector input3;
+		AddStandAloneData(getter, input3);
+		data.push_back(std::move(input3));
+	}
+
+	void AddMinion(Cards::CardId id, state::State & state, state::PlayerIdentifier player)
+	{
+		state::Cards::CardData raw_card = Cards::CardDispatcher::CreateInstance(id);
+		raw_card.enchanted_states.player = player;
+		raw_card.enchantment_handler.SetOriginalStates(raw_card.enchanted_states);
+		raw_card.zone = state::kCardZoneNewlyCreated;
+
+		int pos = (int)state.GetBoard().Get(player).minions_.Size();
+		auto ref = state.AddCard(state::Cards::Card(raw_card));
+		state.GetZoneChanger<state::kCardTypeMinion, state::kCardZoneNewlyCreated>(ref)
+			.ChangeTo<state::kCardZonePlay>(player, pos);
+	}
+
+	// Four minions on each side, the starting hands
+	state::State GetMidGameState()
+	{
+		state::State state = TestStateBuilder().GetState(0);
+		for (state::PlayerIdentifier player : { state::PlayerIdentifier::First(), state::PlayerIdentifier::Second() }) {
+			AddMinion(Cards::ID_EX1_007, state, player); // Acolyte of Pain
+			AddMinion(Cards::ID_NEW1_019, state, player); // Knife Juggler
+			AddMinion(Cards::ID_CS2_122, state, player); // Raid Leader
+			AddMinion(Cards::ID_CS2_120, state, player);
+		}
+		return state;
+	}
+
+	// The best of a few runs, as the other processes on the machine add noise
+	template <class Functor>
+	double Measure(int rounds, Functor && functor)
+	{
+		double best = 0.0;
+		for (int run = 0; run < 5; ++run) {
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < rounds; ++i) functor();
+			auto end = std::chrono::steady_clock::now();
+
+			double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / rounds;
+			if (run == 0 || ns < best) best = ns;
+		}
+		return best;
+	}
+}
+
+namespace benchmark
+{
+	void NeuralNetworkFeatures(std::ostream & s)
+	{
+		if (!Cards::Database::GetInstance().Initialize("cards.json")) {
+			s << "Failed to read cards.json" << std::endl;
+			return;
+		}
+
+		constexpr int kRounds = 1 << 16;
+		state::State state = GetMidGameState();
+
+		// Both paths should give the same features
+		StateDataBridge bridge;
+		bridge.Reset(state);
+		Tensor previous;
+		GetInputData(&bridge, previous);
+		float input[NeuralNetworkInput::kSize];
+		NeuralNetworkStateEncoder::Encode(state, input);
+		std::vector<float> flat;
+		for (auto const& layer : previous) flat.insert(flat.end(), layer.begin(), layer.end());
+		if (!std::equal(flat.begin(), flat.end(), input, input + NeuralNetworkInput::kSize)) {
+			s << "MISMATCH between the encoder and the input getter" << std::endl;
+		}
+
+		s << "method\tns/state\tstates/sec" << std::endl;
+
+		float sum = 0.0f;
+		double getter_ns = Measure(kRounds, [&]() {
+			bridge.Reset(state);
+			Tensor data;
+			GetInputData(&bridge, data);
+			sum += data[2][0];
+		});
+		s << "input getter\t" << getter_ns << "\t" << (1e9 / getter_ns) << std::endl;
+
+		double encoder_ns = Measure(kRounds, [&]() {
+			NeuralNetworkStateEncoder::Encode(state, input);
+			sum += input[NeuralNetworkInput::kStandaloneOffset];
+		});
+		s << "state encoder\t" << encoder_ns << "\t" << (1e9 / encoder_ns) << std::endl;
+		s << "speedup: " << (getter_ns / encoder_ns) << "x" << std::endl;
+
+		if (sum == 0.123f) s << ""; // keep the loops
+	}
+}
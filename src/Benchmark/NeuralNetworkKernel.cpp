@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "NeuralNetworkKernel.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	void SetRandomWeights(NeuralNetworkKernel & kernel, std::mt19937 & rand)
+	{
+		std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+		auto random_weights = [&](size_t size) {
+			std::vector<float> weights(size);
+			for (float & v : weights) v = dist(rand);
+			return weights;
+		};
+
+		kernel.SetHeroConv(
+			random_weights(NeuralNetworkKernel::kHeroInDim * NeuralNetworkKernel::kHeroOutDim).data(),
+			random_weights(NeuralNetworkKernel::kHeroOutDim).data());
+		kernel.SetMinionConv(
+			random_weights(NeuralNetworkKernel::kMinionInDim * NeuralNetworkKernel::kMinionOutDim).data(),
+			random_weights(NeuralNetworkKernel::kMinionOutDim).data());
+		kernel.SetFc1(
+			random_weights(NeuralNetworkKernel::kConcatSize * NeuralNetworkKernel::kFc1OutDim).data(),
+			random_weights(NeuralNetworkKernel::kFc1OutDim).data());
+		kernel.SetFc2(
+			random_weights(NeuralNetworkKernel::kFc1OutDim).data(),
+			random_weights(1).data());
+	}
+
+	// Nanoseconds per evaluation
+	template <class Forward>
+	double Measure(std::vector<float> const& inputs, Forward && forward)
+	{
+		constexpr int kRounds = 200;
+		size_t count = inputs.size() / NeuralNetworkKernel::kInputSize;
+
+		float sum = 0.0f;
+		auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < kRounds; ++round) {
+			for (size_t i = 0; i < count; ++i) {
+				sum += forward(&inputs[i * NeuralNetworkKernel::kInputSize]);
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		if (sum == 0.123f) std::cout << ""; // keep the loop
+
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		return ns / (kRounds * count);
+	}
+}
+
+namespace benchmark
+{
+	void NeuralNetworkInference(std::ostream & s)
+	{
+		// The timing does not depend on the weights
+		std::mt19937 rand(0);
+		NeuralNetworkKernel kernel;
+		SetRandomWeights(kernel, rand);
+
+		// Spread like the normalized features
+		constexpr size_t kInputs = 1024;
+		std::normal_distribution<float> dist(0.0f, 1.0f);
+		std::vector<float> inputs(kInputs * NeuralNetworkKernel::kInputSize);
+		for (float & v : inputs) v = dist(rand);
+
+		double max_diff = 0.0;
+		for (size_t i = 0; i < kInputs; ++i) {
+			float const* input = &inputs[i * NeuralNetworkKernel::kInputSize];
+			double diff = std::abs(kernel.Forward(input) - kernel.ForwardScalar(input));
+			if (diff > max_diff) max_diff = diff;
+		}
+		s << "max difference to scalar: " << max_diff << std::endl;
+
+		double scalar = Measure(inputs, [&](float const* input) { return kernel.ForwardScalar(input); });
+		s << "scalar: " << scalar << " ns/eval" << std::endl;
+
+#ifdef NEURAL_NETWORK_KERNEL_AVX2
+		double avx2 = Measure(inputs, [&](float const* input) { return kernel.ForwardAVX2(input); });
+		s << "avx2: " << avx2 << " ns/eval (x" << (scalar / avx2) << ")" << std::endl;
+#else
+		s << "avx2: not built (needs -mavx2 -mfma)" << std::endl;
+#endif
+	}
+}
@@ -0,0 +1,83 @@
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "NeuralNetworkInput.h"
+#include "NeuralNetworkService.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	// Features in the normalized range
+	std::vector<float> GetInput(int seed)
+	{
+		std::vector<float> input(NeuralNetworkInput::kSize);
+		for (size_t i = 0; i < input.size(); ++i) {
+			input[i] = (float)((seed + (int)i * 7) % 5) * 0.8f - 1.6f;
+		}
+		return input;
+	}
+
+	// Evaluations per second, with 'threads' threads sending requests
+	double Measure(NeuralNetworkService & service, int threads, std::chrono::milliseconds duration)
+	{
+		std::atomic_bool stop(false);
+		std::atomic<uint64_t> evaluations(0);
+		std::vector<std::thread> workers;
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < threads; ++i) {
+			workers.emplace_back([&, i]() {
+				std::vector<float> input = GetInput(i);
+				uint64_t count = 0;
+				double sum = 0.0;
+				while (!stop) {
+					sum += service.Predict(input.data());
+					++count;
+				}
+				evaluations += count;
+				if (sum == 0.123) std::cout << ""; // keep the loop
+			});
+		}
+		std::this_thread::sleep_for(duration);
+		stop = true;
+		for (auto & worker : workers) worker.join();
+		auto end = std::chrono::steady_clock::now();
+
+		double secs = std::chrono::duration<double>(end - start).count();
+		return evaluations / secs;
+	}
+}
+
+namespace benchmark
+{
+	void NeuralNetworkBatch(std::ostream & s)
+	{
+		char const* filename = "simulation_net";
+		if (!std::ifstream(filename)) {
+			s << "Failed to read " << filename << std::endl;
+			return;
+		}
+
+		// The requests come from the search threads, so a batch is at most as
+		// large as the number of threads
+		int threads = 128;
+		s << "threads: " << threads << std::endl;
+		s << "max batch\tavg batch\tevals/sec\tgain" << std::endl;
+
+		double base = 0.0;
+		for (size_t batch_size : { 1, 8, 32, 128 }) {
+			NeuralNetworkService service;
+			service.Initialize(filename);
+			service.SetBatchLimits(batch_size, NeuralNetworkService::kDefaultMaxWait);
+
+			double evals = Measure(service, threads, std::chrono::milliseconds(2000));
+			if (batch_size == 1) base = evals;
+			s << batch_size << "\t" << service.GetAverageBatchSize() << "\t"
+				<< evals << "\t" << (evals / base) << std::endl;
+		}
+	}
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#include "FlowControl/FlowController-impl.h"
+#include "MCTS/TestStateBuilder.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	void AddMinion(Cards::CardId id, state::State & state, state::PlayerIdentifier player)
+	{
+		state::Cards::CardData raw_card = Cards::CardDispatcher::CreateInstance(id);
+		raw_card.enchanted_states.player = player;
+		raw_card.enchantment_handler.SetOriginalStates(raw_card.enchanted_states);
+		raw_card.zone = state::kCardZoneNewlyCreated;
+
+		int pos = (int)state.GetBoard().Get(player).minions_.Size();
+		auto ref = state.AddCard(state::Cards::Card(raw_card));
+		state.GetZoneChanger<state::kCardTypeMinion, state::kCardZoneNewlyCreated>(ref)
+			.ChangeTo<state::kCardZonePlay>(player, pos);
+	}
+
+	// Minions with event handlers and auras on both sides
+	state::State GetMidGameState()
+	{
+		state::State state = TestStateBuilder().GetState(0);
+		for (state::PlayerIdentifier player : { state::PlayerIdentifier::First(), state::PlayerIdentifier::Second() }) {
+			AddMinion(Cards::ID_EX1_007, state, player); // Acolyte of Pain
+			AddMinion(Cards::ID_NEW1_019, state, player); // Knife Juggler
+			AddMinion(Cards::ID_CS2_122, state, player); // Raid Leader
+			AddMinion(Cards::ID_CS2_120, state, player);
+		}
+		return state;
+	}
+
+	template <class Functor>
+	double Measure(int rounds, Functor && functor)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < rounds; ++i) functor();
+		auto end = std::chrono::steady_clock::now();
+
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		return ns / rounds;
+	}
+
+	void Report(std::ostream & s, char const* name, double ns)
+	{
+		s << name << "\t" << ns << "\t" << (1e9 / ns) << std::endl;
+	}
+
+	void MeasureState(std::ostream & s, char const* name, state::State const& root)
+	{
+		constexpr int kRounds = 1 << 17;
+
+		size_t cards = root.GetCardsManager().Size();
+		size_t flat_bytes = sizeof(state::State) + cards * sizeof(state::Cards::Card);
+		s << name << ": " << cards << " cards" << std::endl;
+		s << "method\tns/clone\tclones/sec" << std::endl;
+
+		int turn = 0;
+		Report(s, "copy constructor", Measure(kRounds, [&]() {
+			state::State state(root);
+			turn += state.GetTurn();
+		}));
+
+		state::State recycled(root);
+		Report(s, "assign to a recycled state", Measure(kRounds, [&]() {
+			recycled = root;
+			turn += recycled.GetTurn();
+		}));
+
+		Report(s, "FillWithBase", Measure(kRounds, [&]() {
+			state::State state;
+			state.FillWithBase(root);
+			turn += state.GetTurn();
+		}));
+
+		state::State forked;
+		Report(s, "FillWithBase to a recycled state", Measure(kRounds, [&]() {
+			forked.FillWithBase(root);
+			turn += forked.GetTurn();
+		}));
+
+		// A second layer, e.g., a DFS probe forked from an MCTS iteration
+		state::State probe;
+		Report(s, "FillWithBase on a forked state", Measure(kRounds, [&]() {
+			probe.FillWithBase(forked);
+			turn += probe.GetTurn();
+		}));
+
+		// A DFS probe touching two cards, then rolled back by the next fill
+		state::CardRef first_hero = root.GetBoard().GetFirst().GetHeroRef();
+		state::CardRef second_hero = root.GetBoard().GetSecond().GetHeroRef();
+		Report(s, "probe writing two cards", Measure(kRounds, [&]() {
+			probe.FillWithBase(forked);
+			probe.GetMutableCard(first_hero);
+			probe.GetMutableCard(second_hero);
+			turn += probe.GetTurn();
+		}));
+
+		// The lower bound of a flat snapshot holding the same bytes
+		std::unique_ptr<char[]> src(new char[flat_bytes]());
+		std::unique_ptr<char[]> dest(new char[flat_bytes]);
+		Report(s, "memcpy (flat lower bound)", Measure(kRounds, [&]() {
+			std::memcpy(dest.get(), src.get(), flat_bytes);
+			turn += dest[flat_bytes - 1];
+		}));
+		s << "flat bytes: " << flat_bytes << std::endl;
+
+		if (turn == -1) s << ""; // keep the loops
+	}
+}
+
+namespace benchmark
+{
+	void StateClone(std::ostream & s)
+	{
+		if (!Cards::Database::GetInstance().Initialize("cards.json")) {
+			s << "Failed to read cards.json" << std::endl;
+			return;
+		}
+
+		MeasureState(s, "start of game", TestStateBuilder().GetState(0));
+		s << std::endl;
+		MeasureState(s, "mid-game", GetMidGameState());
+	}
+}
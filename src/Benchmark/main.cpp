@@ -0,0 +1,33 @@
+#include <iostream>
+#include <string>
+
+#include "Benchmarks.h"
+
+int main(int argc, char *argv[])
+{
+	std::string cmd = "all";
+	if (argc >= 2) cmd = argv[1];
+
+	bool matched = false;
+	auto Run = [&](std::string const& name, void(*benchmark)(std::ostream &)) {
+		if (cmd != "all" && cmd != name) return;
+		std::cout << "====== " << name << " =====" << std::endl;
+		benchmark(std::cout);
+		std::cout << std::endl;
+		matched = true;
+	};
+
+	Run("child_node_map", &benchmark::ChildNodeMap);
+	Run("edge_addon", &benchmark::EdgeAddon);
+	Run("board_fingerprint", &benchmark::BoardFingerprint);
+	Run("state_clone", &benchmark::StateClone);
+	Run("nn_features", &benchmark::NeuralNetworkFeatures);
+	Run("nn_batch", &benchmark::NeuralNetworkBatch);
+	Run("nn_kernel", &benchmark::NeuralNetworkInference);
+
+	if (!matched) {
+		std::cout << "Unknown benchmark: " << cmd << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -28,17 +28,19 @@ int main(int argc, char *argv[])
 {
 	Initialize();
 
-	if (argc != 3) {
+	if (argc != 3 && argc != 4) {
 		std::cout << "Usage: "
 			<< argv[0]
 			<< " (threads)"
 			<< " (iterations)"
+			<< " [root-parallel groups]"
 			<< std::endl;
 		return 0;
 	}
 
 	int threads = 1;
 	uint64_t iterations = 1000;
+	int groups = 1;
 
 	auto seed = std::random_device()();
 	std::mt19937 rand(seed);
@@ -51,6 +53,10 @@ int main(int argc, char *argv[])
 		std::istringstream ss(argv[2]);
 		ss >> iterations;
 	}
+	if (argc == 4) {
+		std::istringstream ss(argv[3]);
+		ss >> groups;
+	}
 
 	static_assert(std::is_same_v<
 								mcts::StaticConfigs::SimulationPhaseSelectActionPolicy,
@@ -62,12 +68,19 @@ int main(int argc, char *argv[])
 	std::cout << "Parameters: " << std::endl;
 	std::cout << "\tThreads: " << threads << std::endl;
 	std::cout << "\tIterations: " << iterations << std::endl;
+	std::cout << "\tRoot-parallel groups: " << groups << std::endl;
 	std::cout << "\tSeed: " << seed << std::endl;
 
 	ui::CompetitionGuide guide(rand);
 
-	ui::AICompetitor first;
-	ui::AICompetitor second;
+	ui::AICompetitor first(groups);
+	ui::AICompetitor second(groups);
+
+	// Stops a move early once its best action cannot change
+	ui::TimeManager::Limits limits;
+	limits.iterations = iterations;
+	first.SetLimits(limits);
+	second.SetLimits(limits);
 
 	auto start_board_getter = [&]() -> state::State {
 		return TestStateBuilder().GetStateWithRandomStartCard(rand());
@@ -2,6 +2,7 @@
 #include <chrono>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include "FlowControl/FlowController-impl.h"
 #include "Cards/PreIndexedCards.h"
@@ -25,14 +26,15 @@ struct Configs
 
 int Configs::threads = 0;
 
+static state::State GetStartBoard(int seed)
+{
+	return TestStateBuilder().GetState(seed);
+}
+
 void Run(ui::AIController * controller, int secs)
 {
 	auto & s = std::cout;
 
-	auto start_board_getter = [](int seed) -> state::State {
-		return TestStateBuilder().GetState(seed);
-	};
-
 	auto seed = std::random_device()();
 
 	s << "Running for " << secs << " seconds with " << Configs::threads << " threads "
@@ -57,21 +59,55 @@ void Run(ui::AIController * controller, int secs)
 	};
 
 	auto start_i = controller->GetStatistic().GetSuccededIterates();
-	controller->Run(continue_checker, Configs::threads, seed, start_board_getter);
+	controller->Run(Configs::threads, seed, &GetStartBoard);
+	while (continue_checker()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	controller->WaitUntilStopped();
 	auto end_i = controller->GetStatistic().GetSuccededIterates();
 
 	s << std::endl;
 	s << "Done iterations: " << (end_i - start_i) << std::endl;
 	s << "====== Statistics =====" << std::endl;
-	controller->GetStatistic().GetDebugMessage();
+	s << controller->GetStatistic().GetDebugMessage();
 
 	auto now = std::chrono::steady_clock::now();
 	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
 	auto speed = (double)(end_i - start_i) / ms * 1000;
 	s << "Iterations per second: " << speed << std::endl;
+
+	auto const& budget = controller->GetTreeBudget();
+	s << "Tree nodes: " << budget.GetNodes()
+		<< ", bytes: " << budget.GetBytes()
+		<< (budget.IsExhausted() ? " (expansion suspended)" : "") << std::endl;
 	s << std::endl;
 }
 
+// Report iterations per second for 1, 2, 4, ... max_threads threads
+// Each thread count starts with a fresh tree, so the results are comparable
+void Scale(int secs, int max_threads)
+{
+	auto & s = std::cout;
+	s << "threads\titerations/sec\tspeedup" << std::endl;
+
+	double base_speed = 0.0;
+	for (int threads = 1; threads <= max_threads; threads *= 2) {
+		std::mt19937 rand(0);
+		ui::AIController controller(10000, rand);
+
+		auto start = std::chrono::steady_clock::now();
+		controller.Run(threads, 0, &GetStartBoard);
+		std::this_thread::sleep_for(std::chrono::seconds(secs));
+		controller.WaitUntilStopped();
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+
+		double speed = (double)controller.GetStatistic().GetSuccededIterates() / ms * 1000;
+		if (threads == 1) base_speed = speed;
+		s << threads << "\t" << speed << "\t" << (speed / base_speed) << std::endl;
+	}
+}
+
 bool CheckRun(std::string const& cmdline, ui::AIController * controller)
 {
 	std::stringstream ss(cmdline);
@@ -90,6 +126,22 @@ bool CheckRun(std::string const& cmdline, ui::AIController * controller)
 		Run(controller, secs);
 		return true;
 	}
+
+	if (cmd == "budget") {
+		size_t max_nodes = mcts::TreeBudget::kUnlimited;
+		size_t max_mb = mcts::TreeBudget::kUnlimited >> 20;
+		ss >> max_nodes >> max_mb;
+		controller->SetTreeBudget(max_nodes, max_mb << 20);
+		return true;
+	}
+
+	if (cmd == "scale") {
+		int secs = 10;
+		int max_threads = 32;
+		ss >> secs >> max_threads;
+		Scale(secs, max_threads);
+		return true;
+	}
 	return false;
 }
 
@@ -103,7 +155,7 @@ void TestAI()
 	std::mt19937 rand;
 
 	ui::AIController controller(tree_samples, rand);
-	ui::InteractiveShell handler(&controller);
+	ui::InteractiveShell handler(&controller, &GetStartBoard);
 
 	while (std::cin) {
 		std::string cmdline;
@@ -8,6 +8,8 @@
 #ifdef _MSC_VER
 #define CNN_USE_SSE
 #include <intrin.h> // workaround tiny_dnn issue
+#elif defined(__AVX__)
+#define CNN_USE_AVX // vectorized kernels for the conv and fully-connected layers
 #endif
 
 #include <chrono> // workaround tiny_dnn issue #872
@@ -17,7 +19,14 @@
 #pragma warning (pop)
 #endif
 
+#include <algorithm>
+#include <random>
+#include <thread>
+
 #include "NeuralNetwork.h"
+#include "NeuralNetworkInput.h"
+#include "NeuralNetworkKernel.h"
+#include "NeuralNetworkTrainer.h"
 
 namespace impl {
 	class NeuralNetworkWrapperImpl
@@ -27,32 +36,29 @@ namespace impl {
 		}
 
 		void AddTrainData(NeuralNetworkWrapper::IInputGetter * getter, int label, bool for_validate) {
-			tiny_dnn::tensor_t input;
+			float input[NeuralNetworkInput::kSize];
 			GetInputData(getter, input);
+			AddTrainData(input, label, for_validate);
+		}
 
-			tiny_dnn::vec_t output;
-			output.push_back((float)label);
-
-			if (for_validate) {
-				validate_input_.push_back(input);
-				validate_output_.push_back(output);
-			}
-			else {
-				input_.push_back(input);
-				output_.push_back(output);
-			}
+		void AddTrainData(float const* input, int label, bool for_validate) {
+			if (for_validate) validate_data_.Add(input, (float)label);
+			else train_data_.Add(input, (float)label);
 		}
 
 		void Train() {
-			static constexpr int hero_in_dim = 1;
-			static constexpr int hero_out_dim = 1;
+			// The kernel used in prediction is built for these dimensions
+			static constexpr int hero_in_dim = NeuralNetworkKernel::kHeroInDim;
+			static constexpr int hero_out_dim = NeuralNetworkKernel::kHeroOutDim;
+
+			static constexpr int minion_in_dim = NeuralNetworkKernel::kMinionInDim;
+			static constexpr int minion_out_dim = NeuralNetworkKernel::kMinionOutDim;
 
-			static constexpr int minion_in_dim = 7;
-			static constexpr int minion_out_dim = 3;
+			static constexpr int minion_count = NeuralNetworkKernel::kMinionCount;
 
-			static constexpr int minion_count = 7;
+			static constexpr int standalone_in_dim = NeuralNetworkKernel::kStandaloneInDim;
 
-			static constexpr int standalone_in_dim = 17;
+			static constexpr int fc1_out_dim = NeuralNetworkKernel::kFc1OutDim;
 
 			tiny_dnn::layers::input in_heroes(tiny_dnn::shape3d(
 				hero_in_dim,
@@ -89,218 +95,201 @@ namespace impl {
 
 			auto fc1 = tiny_dnn::fully_connected_layer(
 				2 * hero_out_dim + 2 * minion_count * minion_out_dim + standalone_in_dim,
-				10);
+				fc1_out_dim);
 			concat << fc1;
 
 			auto fc1a = tiny_dnn::activation::leaky_relu();
-			auto fc2 = tiny_dnn::fully_connected_layer(10, 1);
+			auto fc2 = tiny_dnn::fully_connected_layer(fc1_out_dim, 1);
 			fc1 << fc1a << fc2;
 
 			tiny_dnn::construct_graph(net_, { &in_heroes, &in_minions, &in_standalone }, { &fc2 });
 
-			size_t batch_size = 32;
+			// The weights are initialized by tiny-dnn; the training is done by
+			// NeuralNetworkTrainer, and the result is copied back to be saved
+			int threads = std::max((int)std::thread::hardware_concurrency(), 1);
+			NeuralNetworkTrainer trainer(threads);
+			ForEachLayer([&](NeuralNetworkTrainer::Layer layer, tiny_dnn::vec_t & w, tiny_dnn::vec_t & b) {
+				std::copy(w.begin(), w.end(), trainer.GetWeights(layer));
+				std::copy(b.begin(), b.end(), trainer.GetBias(layer));
+			});
+			std::cout << "training with " << threads << " threads" << std::endl;
+
 			int epoch = 10;
 			size_t total_epoch = 0;
-			tiny_dnn::adam opt;
 
 			while (true) {
-				int batch_op_counter = 0;
-				auto batch_op = [batch_op_counter]() mutable {
-					++batch_op_counter;
-					if (batch_op_counter % 10000 == 0) {
-						std::cout << "completed batches: " << batch_op_counter << std::endl;
-					}
-				};
-
-				auto epoch_op = [&total_epoch]() mutable {
+				for (int i = 0; i < epoch; ++i) {
+					auto start = std::chrono::steady_clock::now();
+					double loss = trainer.TrainEpoch(train_data_);
+					double seconds = GetSecondsSince(start);
+
 					++total_epoch;
-					std::cout << "completed epoch: " << total_epoch << std::endl;
-				};
-				net_.fit<tiny_dnn::mse>(opt, input_, output_, batch_size, epoch, batch_op, epoch_op);
+					std::cout << "completed epoch: " << total_epoch
+						<< " (loss: " << loss
+						<< ", " << (size_t)(train_data_.Size() / seconds) << " samples/s)" << std::endl;
+				}
+
+				ForEachLayer([&](NeuralNetworkTrainer::Layer layer, tiny_dnn::vec_t & w, tiny_dnn::vec_t & b) {
+					std::copy(trainer.GetWeights(layer), trainer.GetWeights(layer) + w.size(), w.begin());
+					std::copy(trainer.GetBias(layer), trainer.GetBias(layer) + b.size(), b.begin());
+				});
 
 				std::stringstream ss;
 				ss << "net_result_epoch_" << total_epoch;
 				net_.save(ss.str());
 
-				size_t correct = 0;
-
-				for (size_t idx = 0; idx < input_.size(); ++idx) {
-					auto result = net_.predict(input_[idx]);
-					bool predict_win = (result[0][0] > 0.0);
-					bool actual_win = (output_[idx][0] > 0.0);
-					if (predict_win == actual_win) ++correct;
-				}
-				double rate = ((double)correct) / input_.size();
-				std::cout << "test data correct rate: "
-					<< rate * 100.0 << "% ("
-					<< correct << " / " << input_.size() << ")" << std::endl;
-
-				correct = 0;
-				for (size_t idx = 0; idx < validate_input_.size(); ++idx) {
-					auto result = net_.predict(validate_input_[idx]);
-					bool predict_win = (result[0][0] > 0.0);
-					bool actual_win = (validate_output_[idx][0] > 0.0);
-					if (predict_win == actual_win) ++correct;
-				}
-				rate = ((double)correct) / validate_input_.size();
-				std::cout << "validation correct rate: "
-					<< rate * 100.0 << "% ("
-					<< correct << " / " << validate_input_.size() << ")" << std::endl;
+				trainer.SetKernel(kernel_);
+				PrintCorrectRate("test data", train_data_, threads);
+				PrintCorrectRate("validation", validate_data_, threads);
 			}
 		}
 
 		void InitializePredict(std::string const& filename) {
 			net_.load(filename);
+			LoadKernel();
+			VerifyKernel();
 		}
 
+		// The predictions go through the kernel; tiny-dnn is only used to load
+		// the weights
 		double Predict(NeuralNetworkWrapper::IInputGetter * getter) {
-			tiny_dnn::tensor_t input;
+			float input[NeuralNetworkInput::kSize];
 			GetInputData(getter, input);
-			return net_.predict(input)[0][0];
-		}
-
-	private:
-		void GetInputData(NeuralNetworkWrapper::IInputGetter * getter, tiny_dnn::tensor_t & data) {
-			tiny_dnn::vec_t input1;
-			AddHeroData(NeuralNetworkWrapper::kCurrent, getter, input1);
-			AddHeroData(NeuralNetworkWrapper::kOpponent, getter, input1);
-			data.push_back(std::move(input1));
-
-			tiny_dnn::vec_t input2;
-			AddMinionsData(NeuralNetworkWrapper::kCurrent, getter, input2);
-			AddMinionsData(NeuralNetworkWrapper::kOpponent, getter, input2);
-			data.push_back(std::move(input2));
-
-			tiny_dnn::vec_t input3;
-			AddStandAloneData(getter, input3);
-			data.push_back(std::move(input3));
+			return kernel_.Forward(input);
 		}
 
-		void AddHeroData(
-			NeuralNetworkWrapper::FieldSide side,
-			NeuralNetworkWrapper::IInputGetter * getter,
-			tiny_dnn::vec_t & data)
-		{
-			double hp = getter->GetField(side, NeuralNetworkWrapper::kHeroHP) +
-				getter->GetField(side, NeuralNetworkWrapper::kHeroArmor);
-			data.push_back(NormalizeFromUniformDist(hp, 0.0, 30.0));
-			//data.push_back(player["attack"].asFloat());
-			//data.push_back(player["attackable"].asBool());
+		double Predict(float const* input) {
+			return kernel_.Forward(input);
 		}
 
-		void AddMinionsData(
-			NeuralNetworkWrapper::FieldSide side,
-			NeuralNetworkWrapper::IInputGetter * getter,
-			tiny_dnn::vec_t & data)
-		{
-			int rest = 7;
-			for (int i = 0; i < (int)getter->GetField(side, NeuralNetworkWrapper::kMinionCount); ++i) {
-				if (rest <= 0) throw std::runtime_error("too many minions");
-				AddMinionData(side, getter, i, data);
-				--rest;
-			}
-			while (rest > 0) {
-				AddMinionPlaceHolderData(data);
-				--rest;
+		void Predict(float const* const* inputs, size_t count, double * results) {
+			for (size_t i = 0; i < count; ++i) {
+				results[i] = kernel_.Forward(inputs[i]);
 			}
 		}
 
-		void AddMinionData(
-			NeuralNetworkWrapper::FieldSide side,
-			NeuralNetworkWrapper::IInputGetter * getter,
-			int minion_idx,
-			tiny_dnn::vec_t & data)
-		{
-			data.push_back(NormalizeFromUniformDist(getter->GetField(side, NeuralNetworkWrapper::kMinionHP, minion_idx), 1.0, 7.0));
-			data.push_back(NormalizeFromUniformDist(getter->GetField(side, NeuralNetworkWrapper::kMinionMaxHP, minion_idx), 1.0, 7.0));
-			data.push_back(NormalizeFromUniformDist(getter->GetField(side, NeuralNetworkWrapper::kMinionAttack, minion_idx), 0.0, 7.0));
-			data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionAttackable, minion_idx)));
-			data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionTaunt, minion_idx)));
-			data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionShield, minion_idx)));
-			data.push_back(NormalizeBool(getter->GetField(side, NeuralNetworkWrapper::kMinionStealth, minion_idx)));
-		}
-
-		void AddMinionPlaceHolderData(tiny_dnn::vec_t & data) {
-			data.push_back(0.0);
-			data.push_back(0.0);
-			data.push_back(0.0);
-			data.push_back(NormalizeBool(false));
-			data.push_back(NormalizeBool(false));
-			data.push_back(NormalizeBool(false));
-			data.push_back(NormalizeBool(false));
+	private:
+		// Copies the weights of the conv and fully-connected layers to the kernel
+		void LoadKernel() {
+			ForEachLayer([&](NeuralNetworkTrainer::Layer layer, tiny_dnn::vec_t & w, tiny_dnn::vec_t & b) {
+				switch (layer) {
+				case NeuralNetworkTrainer::kHeroConv: return kernel_.SetHeroConv(w.data(), b.data());
+				case NeuralNetworkTrainer::kMinionConv: return kernel_.SetMinionConv(w.data(), b.data());
+				case NeuralNetworkTrainer::kFc1: return kernel_.SetFc1(w.data(), b.data());
+				case NeuralNetworkTrainer::kFc2: return kernel_.SetFc2(w.data(), b.data());
+				default: throw std::runtime_error("unexpected network layer");
+				}
+			});
 		}
 
-		void AddStandAloneData(
-			NeuralNetworkWrapper::IInputGetter * getter,
-			tiny_dnn::vec_t & data)
-		{
-			data.push_back(NormalizeFromUniformDist(getter->GetField(
-				NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceCurrent), 0, 10));
-			data.push_back(NormalizeFromUniformDist(getter->GetField(
-				NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceTotal), 0, 10));
-			data.push_back(NormalizeFromUniformDist(getter->GetField(
-				NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kResourceOverloadNext), 0, 10));
-
-			int cur_hand_count = (int)getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandCount);
-			data.push_back(NormalizeFromUniformDist(cur_hand_count, 0, 10));
-
-			int cur_hand_playable = 0;
-			for (int i = 0; i < cur_hand_count; ++i) {
-				bool playable = getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandPlayable, i);
-				if (playable) {
-					++cur_hand_playable;
+		// Calls 'functor(layer, weights, bias)' for each of the conv and
+		// fully-connected layers, after checking the weights sizes
+		template <class Functor>
+		void ForEachLayer(Functor && functor) {
+			bool found[NeuralNetworkTrainer::kLayers] = {};
+
+			for (size_t i = 0; i < net_.layer_size(); ++i) {
+				tiny_dnn::layer * layer = net_[i];
+				std::string type = layer->layer_type();
+				if (type != "conv" && type != "fully-connected") continue;
+
+				std::vector<tiny_dnn::vec_t*> weights = layer->weights();
+				if (weights.size() != 2) throw std::runtime_error("unexpected layer weights");
+
+				// The layers are told apart by their input sizes
+				NeuralNetworkTrainer::Layer kind;
+				size_t in_size = layer->in_data_size();
+				if (type == "conv" && in_size == NeuralNetworkKernel::kHeroInputSize) {
+					kind = NeuralNetworkTrainer::kHeroConv;
+				}
+				else if (type == "conv" && in_size == NeuralNetworkKernel::kMinionInputSize) {
+					kind = NeuralNetworkTrainer::kMinionConv;
+				}
+				else if (type == "fully-connected" && in_size == NeuralNetworkKernel::kConcatSize) {
+					kind = NeuralNetworkTrainer::kFc1;
 				}
+				else if (type == "fully-connected" && in_size == NeuralNetworkKernel::kFc1OutDim) {
+					kind = NeuralNetworkTrainer::kFc2;
+				}
+				else {
+					throw std::runtime_error("unexpected network layer");
+				}
+
+				CheckWeightsSize(*weights[0], *weights[1],
+					NeuralNetworkTrainer::GetWeightsSize(kind), NeuralNetworkTrainer::GetBiasSize(kind));
+				functor(kind, *weights[0], *weights[1]);
+				found[kind] = true;
 			}
-			data.push_back(NormalizeFromUniformDist(cur_hand_playable, 0, 10));
 
-			int hand_cards = 0;
-			for (int i = 0; i < cur_hand_count; ++i) {
-				data.push_back(NormalizeFromUniformDist(
-					getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHandCost, i), 0, 10));
-				++hand_cards;
+			for (bool v : found) {
+				if (!v) throw std::runtime_error("unexpected network topology");
 			}
-			while (hand_cards < 10) {
-				data.push_back(NormalizeFromUniformDist(-1, 0, 10));
-				++hand_cards;
+		}
+
+		static void CheckWeightsSize(tiny_dnn::vec_t const& w, tiny_dnn::vec_t const& b, size_t w_size, size_t b_size) {
+			if (w.size() != w_size || b.size() != b_size) {
+				throw std::runtime_error("unexpected layer weights size");
 			}
+		}
 
-			int opn_hand_count = (int)getter->GetField(NeuralNetworkWrapper::kOpponent, NeuralNetworkWrapper::kHandCount);
-			data.push_back(NormalizeFromUniformDist(opn_hand_count, 0, 10));
+		// The kernel should agree with tiny-dnn, up to the rounding of the
+		// reordered sums
+		void VerifyKernel() {
+			static constexpr double kTolerance = 1e-4;
 
-			data.push_back(NormalizeBool(
-				getter->GetField(NeuralNetworkWrapper::kCurrent, NeuralNetworkWrapper::kHeroPowerPlayable)));
+			std::mt19937 rand(0);
+			std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+			float input[NeuralNetworkKernel::kInputSize];
+			for (int round = 0; round < 16; ++round) {
+				for (float & v : input) v = dist(rand);
+
+				tiny_dnn::tensor_t net_input;
+				GetInputData(input, net_input);
+
+				double expected = net_.predict(net_input)[0][0];
+				double actual = kernel_.Forward(input);
+				if (std::abs(expected - actual) > kTolerance * (1.0 + std::abs(expected))) {
+					throw std::runtime_error("neural network kernel does not match tiny-dnn");
+				}
+			}
 		}
 
-		tiny_dnn::float_t NormalizeFromUniformDist(double v, double min, double max) {
-			// normalize to mean = 0, var = 1.0
-			// uniform dist is with variance = (max-min)^2 / 12
-			// --> so we should have (max-min)^2 / 12 = 1.0
-			// --> (max-min)^2 = 12.0
-			// --> (max-min) = sqrt(12.0)
-			static double sqrt_12 = std::sqrt(12.0);
+		void PrintCorrectRate(char const* name, NeuralNetworkTrainer::DataSet const& data, int threads) {
+			auto start = std::chrono::steady_clock::now();
+			size_t correct = NeuralNetworkTrainer::CountCorrect(data, kernel_, threads);
+			double seconds = GetSecondsSince(start);
+
+			double rate = ((double)correct) / data.Size();
+			std::cout << name << " correct rate: "
+				<< rate * 100.0 << "% ("
+				<< correct << " / " << data.Size() << ", "
+				<< (size_t)(data.Size() / seconds) << " samples/s)" << std::endl;
+		}
 
-			double mean = (min + max) / 2;
-			double range = (max - min);
-			double scale = sqrt_12 / range;
+		static double GetSecondsSince(std::chrono::steady_clock::time_point start) {
+			auto duration = std::chrono::steady_clock::now() - start;
+			return std::max(std::chrono::duration<double>(duration).count(), 1e-9);
+		}
 
-			double ret = (v - mean) * scale;
-			return (tiny_dnn::float_t)ret;
+		void GetInputData(NeuralNetworkWrapper::IInputGetter * getter, float * input) {
+			NeuralNetworkInput::Encode(getter, input);
 		}
 
-		tiny_dnn::float_t NormalizeBool(bool v) {
-			double vv = 0.0;
-			if (v) vv = 1.0;
-			else vv = -1.0;
-			double ret = NormalizeFromUniformDist(vv, -1.0, 1.0);
-			return (tiny_dnn::float_t)ret;
+		// The three input layers of the tiny-dnn graph
+		void GetInputData(float const* input, tiny_dnn::tensor_t & data) {
+			float const* heroes = input + NeuralNetworkInput::kHeroesOffset;
+			float const* minions = input + NeuralNetworkInput::kMinionsOffset;
+			float const* standalone = input + NeuralNetworkInput::kStandaloneOffset;
+			data.emplace_back(heroes, minions);
+			data.emplace_back(minions, standalone);
+			data.emplace_back(standalone, standalone + NeuralNetworkKernel::kStandaloneInDim);
 		}
 
 	private:
-		std::vector<tiny_dnn::tensor_t> input_;
-		std::vector<tiny_dnn::vec_t> output_;
-		std::vector<tiny_dnn::tensor_t> validate_input_;
-		std::vector<tiny_dnn::vec_t> validate_output_;
+		NeuralNetworkTrainer::DataSet train_data_;
+		NeuralNetworkTrainer::DataSet validate_data_;
 		tiny_dnn::network<tiny_dnn::graph> net_;
+		NeuralNetworkKernel kernel_;
 	};
 }
 
@@ -320,6 +309,11 @@ void NeuralNetworkWrapper::AddTrainData(IInputGetter * getter, int label, bool f
 	impl_->AddTrainData(getter, label, for_validate);
 }
 
+void NeuralNetworkWrapper::AddTrainData(float const* input, int label, bool for_validate)
+{
+	impl_->AddTrainData(input, label, for_validate);
+}
+
 void NeuralNetworkWrapper::Train()
 {
 	impl_->Train();
@@ -335,3 +329,13 @@ double NeuralNetworkWrapper::Predict(IInputGetter * getter)
 {
 	return impl_->Predict(getter);
 }
+
+double NeuralNetworkWrapper::Predict(float const* input)
+{
+	return impl_->Predict(input);
+}
+
+void NeuralNetworkWrapper::Predict(float const* const* inputs, size_t count, double * results)
+{
+	impl_->Predict(inputs, count, results);
+}
@@ -10,6 +10,8 @@
 #include "json/json.h"
 
 #include "NeuralNetwork.h"
+#include "NeuralNetworkInput.h"
+#include "NeuralNetworkTrainData.h"
 
 class JsonDataParser : public NeuralNetworkWrapper::IInputGetter
 {
@@ -149,25 +151,48 @@ public:
 		net_.InitializeTrain();
 	}
 
-	void AddJsonFile(std::string const& filename, bool for_validate) {
+	void AddFile(std::string const& filename, bool for_validate) {
+		if (IsBinaryFile(filename)) {
+			NeuralNetworkTrainData::Reader reader(filename);
+			for (size_t idx = 0; idx < reader.Size(); ++idx) {
+				auto const& sample = reader.Get(idx);
+				if (sample.turn <= kSkipTurns) continue;
+				net_.AddTrainData(sample.input, sample.label, for_validate);
+			}
+		}
+		else {
+			ForEachJsonSample(filename, [&](NeuralNetworkTrainData::Sample const& sample) {
+				if (sample.turn <= kSkipTurns) return;
+				net_.AddTrainData(sample.input, sample.label, for_validate);
+			});
+		}
+	}
+
+	static bool IsBinaryFile(std::string const& filename) {
+		static std::string const extension = ".bin";
+		return filename.size() >= extension.size() &&
+			filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+	}
+
+	// Encodes the boards of a json game record
+	template <class Functor>
+	static void ForEachJsonSample(std::string const& filename, Functor && functor) {
 		Json::Value obj;
 		Json::Reader reader;
 		std::ifstream fs(filename);
 		reader.parse(fs, obj);
 
 		std::string result = GetResult(obj);
-		int seq = 1;
 		for (Json::ArrayIndex idx = 0; idx < obj.size(); ++idx) {
 			if (obj[idx]["type"].asString() == "kMainAction") {
 				Json::Value const& board = obj[idx]["board"];
 
-				if (board["turn"].asInt() <= 4) continue;
-
 				JsonDataParser board_parser(board);
-				int label = IsCurrentPlayerWin(board, result) ? 1 : -1;
-
-				net_.AddTrainData(&board_parser, label, for_validate);
-				++seq;
+				NeuralNetworkTrainData::Sample sample;
+				NeuralNetworkInput::Encode(&board_parser, sample.input);
+				sample.label = IsCurrentPlayerWin(board, result) ? 1 : -1;
+				sample.turn = board["turn"].asInt();
+				functor(sample);
 			}
 		}
 	}
@@ -178,7 +203,10 @@ public:
 	}
 
 private:
-	std::string GetResult(Json::Value const& obj) {
+	// The first turns are mostly decided by the starting hands
+	static constexpr int kSkipTurns = 4;
+
+	static std::string GetResult(Json::Value const& obj) {
 		for (Json::ArrayIndex idx = 0; idx < obj.size(); ++idx) {
 			if (obj[idx]["type"].asString() == "kEnd") {
 				return obj[idx]["result"].asString();
@@ -187,13 +215,13 @@ private:
 		throw std::runtime_error("Cannot find win player");
 	}
 
-	bool IsResultWin(std::string const& win_player) {
+	static bool IsResultWin(std::string const& win_player) {
 		if (win_player == "kResultWin") return true;
 		if (win_player == "kResultLoss") return false;
 		throw std::runtime_error("Failed to parse winning player");
 	}
 
-	bool IsCurrentPlayerWin(Json::Value const& board, std::string const& result) {
+	static bool IsCurrentPlayerWin(Json::Value const& board, std::string const& result) {
 		std::string current_player = board["current_player_id"].asString();
 
 		bool current_player_is_first = false;
@@ -211,17 +239,54 @@ private:
 	NeuralNetworkWrapper net_;
 };
 
+// Writes a binary file next to each json file in the file list, and lists
+// them in 'filelist_binary'
+static int ConvertToBinary(std::string const& dirname)
+{
+	std::ifstream filelist(dirname + "/filelist");
+	std::ofstream binary_filelist(dirname + "/filelist_binary", std::ios::trunc);
+
+	int converted_files = 0;
+	while (filelist) {
+		std::string filename;
+		filelist >> filename;
+		if (filename.empty()) continue;
+		if (Trainer::IsBinaryFile(filename)) continue;
+
+		std::string binary_filename = filename.substr(0, filename.find_last_of('.')) + ".bin";
+		NeuralNetworkTrainData::Writer writer(dirname + "/" + binary_filename);
+		Trainer::ForEachJsonSample(dirname + "/" + filename, [&](NeuralNetworkTrainData::Sample const& sample) {
+			writer.Write(sample);
+		});
+		writer.Close();
+		binary_filelist << binary_filename << std::endl;
+
+		++converted_files;
+		if (converted_files % 100 == 0) {
+			std::cout << "Converted " << converted_files << " files" << std::endl;
+		}
+	}
+	std::cout << "Converted " << converted_files << " files" << std::endl;
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
-	if (argc != 2) {
-		std::cout << "Usage: (program) (dirname)" << std::endl;
+	if (argc == 3 && std::string(argv[1]) == "convert") {
+		return ConvertToBinary(argv[2]);
+	}
+
+	if (argc != 2 && argc != 3) {
+		std::cout << "Usage: (program) (dirname) [filelist]" << std::endl;
+		std::cout << "       (program) convert (dirname)" << std::endl;
+		std::cout << "The file list holds the json or the binary (.bin) game records to train on." << std::endl;
 		return -1;
 	}
 
 	Trainer trainer;
 
 	std::string dirname = argv[1];
-	std::string filelist_path = dirname + "/filelist";
+	std::string filelist_path = dirname + "/" + (argc == 3 ? argv[2] : "filelist");
 
 	std::cout << "Reading from dir: " << dirname << std::endl;
 	std::cout << "Filelist file: " << filelist_path << std::endl;
@@ -243,7 +308,7 @@ int main(int argc, char **argv)
 		bool for_validate = unif(rand) < validation_case_rate;
 
 		try {
-			trainer.AddJsonFile(dirname + "/" + filename, for_validate);
+			trainer.AddFile(dirname + "/" + filename, for_validate);
 		}
 		catch (...) {
 			std::cout << "Failed when loading file " << filename << std::endl;
@@ -8,6 +8,7 @@
 #include "UI/BoardGetter.h"
 #include "UI/GameEngine.h"
 #include "UI/InteractiveShell.h"
+#include "UI/TimeManager.h"
 #include "FlowControl/FlowController-impl.h"
 #include "Cards/PreIndexedCards.h"
 
@@ -18,8 +19,10 @@ namespace ui
 		GameEngineImpl() :
 			logger_(),
 			running_(false),
+			stop_requested_(false),
 			controller_(),
-			board_getter_(logger_)
+			board_getter_(logger_),
+			time_manager_()
 		{}
 
 		int Initialize(int root_sample_count) {
@@ -68,6 +71,18 @@ namespace ui
 			return rc;
 		}
 
+		int Ponder(int threads) {
+			if (running_.exchange(true)) {
+				Log("Still running.");
+				return -1;
+			}
+
+			int rc = InternalPonder(threads);
+
+			running_ = false;
+			return rc;
+		}
+
 		int InteractiveShell(std::string const& cmd)
 		{
 			shell_.SetController(controller_.get());
@@ -88,9 +103,20 @@ namespace ui
 			return oss.str();
 		}
 
+		// The request is latched until ResetStop(), so it is not lost if it comes
+		// before the search starts. The threads are stopped by the caller of the
+		// time manager (see Search), so the controller is not touched here.
 		int NotifyStop()
 		{
-			return controller_->NotifyStop();
+			stop_requested_ = true;
+			time_manager_.NotifyStop();
+			return 0;
+		}
+
+		int ResetStop()
+		{
+			stop_requested_ = false;
+			return 0;
 		}
 
 		void SetOutputMessageCallback(GameEngine::OutputMessageCallback cb)
@@ -99,11 +125,25 @@ namespace ui
 		}
 
 	private:
+		// A complex move might think up to this much longer than asked, see TimeManager
+		static constexpr double kMaxTimeExtension = 0.5;
+
 		void Log(std::string const& msg)
 		{
 			logger_.Log(msg);
 		}
 
+		static char const* GetStopReasonName(TimeManager::StopReason reason)
+		{
+			switch (reason) {
+			case TimeManager::kStopRequested: return "requested";
+			case TimeManager::kIterationLimit: return "iteration limit";
+			case TimeManager::kTimeLimit: return "time limit";
+			case TimeManager::kDecided: return "best action decided";
+			default: return "unknown";
+			}
+		}
+
 		int InternalRun(int seconds, int threads)
 		{
 			auto seed = std::random_device()();
@@ -115,19 +155,50 @@ namespace ui
 				return -1;
 			}
 
-			auto run_until = std::chrono::steady_clock::now() +
-				std::chrono::seconds(seconds);
+			TimeManager::Limits limits;
+			limits.time = std::chrono::seconds(seconds);
+			limits.max_extension = kMaxTimeExtension;
+			limits.threads = threads;
+			return Search(limits, seed);
+		}
 
-			long long last_report_rest_sec = -1;
-			auto continue_checker = [&]() {
-				auto now = std::chrono::steady_clock::now();
-				if (now > run_until) return false;
+		// Keeps growing the trees of the last run, e.g., in the opponent's turn
+		// The board is not parsed again, since it is always parsed as in our turn.
+		// The iterations go on from the root samples of the last run, through the
+		// end of our turn into the opponent's. When the next board comes, the
+		// node of our next turn is promoted with the visits gained here (see
+		// AIController::UpdateRoot).
+		int InternalPonder(int threads)
+		{
+			if (!controller_) {
+				Log("Nothing to ponder on; should run first.");
+				return -1;
+			}
 
-				auto rest_sec = std::chrono::duration_cast<std::chrono::seconds>(run_until - now).count();
-				if (rest_sec != last_report_rest_sec) {
+			Log("Start to ponder.");
+
+			TimeManager::Limits limits; // until stopped
+			limits.threads = threads;
+			return Search(limits, std::random_device()());
+		}
+
+		int Search(TimeManager::Limits const& limits, int seed)
+		{
+			bool has_time_limit = limits.time > TimeManager::Clock::duration::zero();
+			auto start_time = TimeManager::Clock::now();
+
+			long long last_report_sec = -1;
+			auto continue_checker = [&](uint64_t) {
+				if (controller_->IsStopping()) return false;
+
+				auto now = TimeManager::Clock::now();
+				auto report_sec = has_time_limit ?
+					std::chrono::duration_cast<std::chrono::seconds>(time_manager_.GetDeadline() - now).count() :
+					std::chrono::duration_cast<std::chrono::seconds>(now - start_time).count();
+				if (report_sec != last_report_sec) {
 					{
 						std::stringstream ss;
-						ss << "Rest seconds: " << rest_sec;
+						ss << (has_time_limit ? "Rest seconds: " : "Pondered seconds: ") << report_sec;
 						Log(ss.str());
 					}
 
@@ -138,25 +209,60 @@ namespace ui
 						Log(ss.str());
 					}
 
-					last_report_rest_sec = rest_sec;
+					{
+						std::stringstream ss;
+						ss << "Tree memory: " << (controller_->GetTreeMemoryUsage() >> 20) << " MB";
+						Log(ss.str());
+					}
+
+					{
+						std::stringstream ss;
+						auto const& budget = controller_->GetTreeBudget();
+						ss << "Tree nodes: " << budget.GetNodes()
+							<< " (" << (budget.GetBytes() >> 20) << " MB)";
+						if (budget.IsExhausted()) ss << ", expansion suspended";
+						Log(ss.str());
+					}
+
+					last_report_sec = report_sec;
 				}
 				return true;
 			};
 
-			auto start_board_getter = [this](int seed) -> state::State {
-				return board_getter_.GetStartBoard(seed);
+			auto start_iterations = controller_->GetStatistic().GetSuccededIterates();
+			auto iterations_getter = [&]() -> uint64_t {
+				return controller_->GetStatistic().GetSuccededIterates() - start_iterations;
 			};
 
-			try {
-				controller_->Run(threads, seed, start_board_getter);
+			// The board is always seen by the first player
+			auto root_visits_getter = [&](std::vector<int64_t> & visits) {
+				auto root = controller_->GetRootNode(state::kPlayerFirst);
+				if (!root) return;
+				root->ForEachChild([&](int, mcts::selection::ChildType const& child) {
+					visits.push_back(child.GetEdgeAddon().GetChosenTimes());
+					return true;
+				});
+			};
 
-				while (true) {
-					if (!continue_checker()) break;
-					if (controller_->IsStopping()) break;
-					std::this_thread::sleep_for(std::chrono::milliseconds(100));
-				}
+			auto root_sample_getter = [this](int seed) -> state::State const& {
+				return board_getter_.GetRootSample(seed);
+			};
+
+			try {
+				controller_->RunOnRootSamples(limits.threads, seed, root_sample_getter);
 
+				time_manager_.Start(limits);
+				if (stop_requested_) time_manager_.NotifyStop(); // requested before the start
+				auto reason = time_manager_.Wait(iterations_getter, root_visits_getter, continue_checker);
 				controller_->WaitUntilStopped();
+
+				std::stringstream ss;
+				ss << "Stopped (" << GetStopReasonName(reason) << ")"
+					<< " after " << iterations_getter() << " iterations";
+				if (time_manager_.GetExtension() > 0.0) {
+					ss << ", time extended by " << (int)(time_manager_.GetExtension() * 100.0) << "%";
+				}
+				Log(ss.str());
 			}
 			catch (...) {
 				return -1;
@@ -168,9 +274,11 @@ namespace ui
 	private:
 		GameEngineLogger logger_;
 		std::atomic<bool> running_;
+		std::atomic<bool> stop_requested_;
 		std::unique_ptr<ui::AIController> controller_;
 		ui::InteractiveShell shell_;
 		ui::BoardGetter board_getter_;
+		TimeManager time_manager_;
 	};
 
 	GameEngine::GameEngine() : impl_(nullptr) {
@@ -190,7 +298,9 @@ namespace ui
 	int GameEngine::ResetBoard() { return impl_->ResetBoard(); }
 	int GameEngine::UpdateBoard(std::string const& board) { return impl_->UpdateBoard(board); }
 	int GameEngine::Run(int seconds, int threads) { return impl_->Run(seconds, threads); }
+	int GameEngine::Ponder(int threads) { return impl_->Ponder(threads); }
 	int GameEngine::NotifyStop() { return impl_->NotifyStop(); }
+	int GameEngine::ResetStop() { return impl_->ResetStop(); }
 	int GameEngine::InteractiveShell(std::string const& cmd) { return impl_->InteractiveShell(cmd); }
 	std::string GameEngine::GetBestChoice() { return impl_->GetBestChoice(); }
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <assert.h>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "FlowControl/FlowController-impl.h"
+#include "Cards/PreIndexedCards.h"
+#include "MCTS/TestStateBuilder.h"
+#include "MCTS/board/Board.h"
+#include "MCTS/board/BoardActionAnalyzer-impl.h"
+
+// Playouts should not touch the heap once the reused objects (the state, the
+// action analyzer and the flow context) are warmed up.
+// Some games are played to warm them up, and the allocations in the games
+// played afterwards, with new seeds, are counted. A new game might still set
+// a new high-water mark (e.g., a minion stacking more enchantments than in any
+// game before), so a few allocations are allowed.
+
+static long long g_allocations = 0;
+
+// The replaced operators all go through these, so a pointer is always freed
+// by the allocation function's counterpart
+static void * Allocate(size_t size)
+{
+	++g_allocations;
+	void * p = std::malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+static void Deallocate(void * p) noexcept { std::free(p); }
+
+void * operator new(size_t size) { return Allocate(size); }
+void * operator new[](size_t size) { return Allocate(size); }
+void operator delete(void * p) noexcept { Deallocate(p); }
+void operator delete(void * p, size_t) noexcept { Deallocate(p); }
+void operator delete[](void * p) noexcept { Deallocate(p); }
+void operator delete[](void * p, size_t) noexcept { Deallocate(p); }
+
+class RandomGenerator : public mcts::board::IRandomGenerator
+{
+public:
+	RandomGenerator(int seed) : rand_(seed) {}
+	int Get(int exclusive_max) final { return (int)(rand_() % exclusive_max); }
+
+private:
+	std::mt19937 rand_;
+};
+
+class ActionParameterGetter : public mcts::board::IActionParameterGetter
+{
+public:
+	ActionParameterGetter(int seed) : rand_(seed) {}
+	int GetNumber(mcts::ActionType::Types, mcts::board::ActionChoices const& action_choices) final {
+		return action_choices.Get(rand_() % action_choices.Size());
+	}
+
+private:
+	std::mt19937 rand_;
+};
+
+static void PlayGame(
+	int seed, state::State & state,
+	mcts::board::BoardActionAnalyzer & action_analyzer,
+	FlowControl::FlowContext & flow_context)
+{
+	RandomGenerator random(seed);
+	ActionParameterGetter action_parameters(seed + 1);
+	std::mt19937 rand(seed + 2);
+
+	while (true) {
+		mcts::board::Board board(state, state.GetCurrentPlayerId().GetSide());
+		action_analyzer.Reset();
+		int choices = board.GetActionsCount(action_analyzer);
+		assert(choices > 0);
+
+		flow_context.Reset();
+		auto result = board.ApplyAction((int)(rand() % choices), action_analyzer, flow_context, random, action_parameters);
+		if (result.type_ != mcts::Result::kResultNotDetermined) break;
+	}
+}
+
+int main(void)
+{
+	std::cout << "Reading json file...";
+	if (!Cards::Database::GetInstance().Initialize("cards.json")) {
+		std::cout << " Failed." << std::endl;
+		return 1;
+	}
+	Cards::PreIndexedCards::GetInstance().Initialize();
+	std::cout << " Done." << std::endl;
+
+	constexpr int kWarmUpGames = 1000;
+	constexpr int kGames = 100;
+	constexpr long long kMaxAllocations = kGames / 10;
+	std::vector<state::State> roots;
+	for (int i = 0; i < 10; ++i) {
+		roots.push_back(TestStateBuilder().GetStateWithRandomStartCard(i));
+	}
+
+	state::State state;
+	mcts::board::BoardActionAnalyzer action_analyzer;
+	FlowControl::FlowContext flow_context;
+
+	// The seeds of the measured games are not played in the warm-up
+	auto play_games = [&](int first_seed, int games) {
+		long long start = g_allocations;
+		for (int seed = first_seed; seed < first_seed + games; ++seed) {
+			state.FillWithBase(roots[seed % roots.size()]);
+			PlayGame(seed, state, action_analyzer, flow_context);
+		}
+		return g_allocations - start;
+	};
+	long long warm_up_allocations = play_games(0, kWarmUpGames);
+	long long allocations = play_games(kWarmUpGames, kGames);
+
+	std::cout << "Heap allocations in " << kWarmUpGames << " warm-up playouts: " << warm_up_allocations << std::endl;
+	std::cout << "Heap allocations in " << kGames << " warmed-up playouts: " << allocations << std::endl;
+	if (allocations > kMaxAllocations) {
+		std::cout << "FAILED" << std::endl;
+		return 1;
+	}
+	std::cout << "PASSED" << std::endl;
+	return 0;
+}
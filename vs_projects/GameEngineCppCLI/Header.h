@@ -24,7 +24,9 @@ namespace GameEngineCppWrapper
 			int UpdateBoard(System::String^ board);
 
 			int Run(int seconds, int threads);
+			int Ponder(int threads);
 			int NotifyStop();
+			int ResetStop();
 			System::String^ GetBestChoice();
 
 			int InteractiveShell(System::String^ cmd);
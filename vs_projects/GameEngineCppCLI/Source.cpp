@@ -57,11 +57,21 @@ namespace GameEngineCppWrapper
 			return impl_->Run(seconds, threads);
 		}
 
+		int GameEngine::Ponder(int threads)
+		{
+			return impl_->Ponder(threads);
+		}
+
 		int GameEngine::NotifyStop()
 		{
 			return impl_->NotifyStop();
 		}
 
+		int GameEngine::ResetStop()
+		{
+			return impl_->ResetStop();
+		}
+
 		int GameEngine::InteractiveShell(System::String^ cmd)
 		{
 			return impl_->InteractiveShell(msclr::interop::marshal_as<std::string>(cmd));
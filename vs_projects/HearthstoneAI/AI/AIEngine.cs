@@ -51,6 +51,7 @@ namespace HearthstoneAI.AI
         public int Reset()
         {
             AbortRunner();
+            has_run_ = false; // the trees are restarted by the next run
             if (engine_.ResetBoard() < 0) return -1;
             return 0;
         }
@@ -83,6 +84,7 @@ namespace HearthstoneAI.AI
         }
 
         private DateTime last_run_start = DateTime.MaxValue;
+        private bool has_run_ = false; // the engine has the trees of a run to ponder on
         public int Run(int seconds, int threads)
         {
             if (!IsInitialized())
@@ -92,6 +94,7 @@ namespace HearthstoneAI.AI
             }
 
             AbortRunner();
+            engine_.ResetStop(); // a stop from now on is kept for the runner
 
             runner_ = new System.Threading.Thread(() =>
             {
@@ -101,6 +104,36 @@ namespace HearthstoneAI.AI
             });
             runner_.Start();
             last_run_start = DateTime.Now;
+            has_run_ = true;
+
+            return 0;
+        }
+
+        // Keeps searching on the last run in the opponent's turn, until aborted
+        public int Ponder(int threads)
+        {
+            if (!IsInitialized())
+            {
+                logger_.Info("Engine is not initialized.");
+                return -1;
+            }
+
+            if (!has_run_)
+            {
+                logger_.Info("Nothing to ponder on; should run first.");
+                return -1;
+            }
+
+            AbortRunner();
+            engine_.ResetStop(); // a stop from now on is kept for the runner
+
+            runner_ = new System.Threading.Thread(() =>
+            {
+                logger_.Info(String.Format("Start pondering with {0} threads.", threads));
+                engine_.Ponder(threads);
+                logger_.Info("Finish pondering.");
+            });
+            runner_.Start();
 
             return 0;
         }
@@ -58,12 +58,16 @@ namespace HearthstoneAI
                 {
                     ai_engine_.UpdateBoard(board);
 
+                    int threads = Convert.ToInt32(Math.Round(nudThreads.Value, 0));
                     if (game_state.GetCurrentPlayerEntityId() == game_state.PlayerEntityId)
                     {
                         int seconds = Convert.ToInt32(Math.Round(nudSeconds.Value, 0));
-                        int threads = Convert.ToInt32(Math.Round(nudThreads.Value, 0));
                         ai_engine_.Run(seconds, threads);
                     }
+                    else
+                    {
+                        ai_engine_.Ponder(threads);
+                    }
                 }
             };
 